@@ -26,28 +26,86 @@
 
 
 #include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 #include <opencv2/opencv.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <unistd.h>
 
 #include "HandDetector.h"
 #include "HandDescriptor.h"
+#include "HandsManager.h"
 #include "handUtils.h"
 #include "mouse.h"
 #include "StateMachine.h"
 #include "AppLauncher.h"
+#include "CaptureFrameSource.h"
+#include "RawYUVFileSource.h"
+
+//-- Background learnt on the last run, to start with it instead of from scratch
+static const std::string BACKGROUND_FILE = "../data/background.model";
 
 
 int main( int argc, char * argv[] )
 {
+    //-- Command line
+    //--------------------------------------------------------------
+    //-- Usage: gecko [--profile <file>] [--save-profile <file>] [--skin-box hsv|ycrcb|rg|bgr]
+    //--              [--yuv] [--raw-yuv yuyv|nv12 <width>x<height>] [--processing-size <width>x<height>]
+    //--              [--hands <n>] [--motion-gate <fraction>] [video source]
+    std::string source;
+    std::string profile_file;       //-- Calibration to load, skipping the interactive screens
+    std::string save_profile_file;  //-- Where to store the interactive calibration
+    std::string skin_box = "hsv";   //-- Color space of the skin box used with the default values
+    bool native_yuv = false;        //-- Process the YUV frames of the camera, without converting them to BGR
+    std::string raw_yuv_format;     //-- If set, the video source is a file of raw frames in this format
+    cv::Size raw_yuv_size;          //-- Size of the raw frames
+    cv::Size processing_size;       //-- If set, MJPEG frames are scaled down to about this size while decoding
+    int max_hands = 1;              //-- Hands tracked and shown (the cursor follows the one tracked for longest)
+    double motion_gate = 0;         //-- Min. fraction of changed pixels to process a frame (0: process all)
+
+    for ( int i = 1; i < argc; i++ )
+    {
+        std::string arg = argv[i];
+        if ( arg == "--profile" && i + 1 < argc )
+            profile_file = argv[++i];
+        else if ( arg == "--save-profile" && i + 1 < argc )
+            save_profile_file = argv[++i];
+        else if ( arg == "--skin-box" && i + 1 < argc )
+            skin_box = argv[++i];
+        else if ( arg == "--yuv" )
+            native_yuv = true;
+        else if ( arg == "--raw-yuv" && i + 2 < argc )
+        {
+            raw_yuv_format = argv[++i];
+            sscanf( argv[++i], "%dx%d", &raw_yuv_size.width, &raw_yuv_size.height );
+        }
+        else if ( arg == "--processing-size" && i + 1 < argc )
+            sscanf( argv[++i], "%dx%d", &processing_size.width, &processing_size.height );
+        else if ( arg == "--hands" && i + 1 < argc )
+            max_hands = std::max( 1, atoi( argv[++i] ) );
+        else if ( arg == "--motion-gate" && i + 1 < argc )
+            motion_gate = atof( argv[++i] );
+        else
+            source = arg;
+    }
+
+
     //-- Setup video
     //--------------------------------------------------------------
     cv::VideoCapture cap;
+    FrameSource * frame_source = NULL;
 
     //-- Open video source
-    if ( argc > 1)
+    if ( !raw_yuv_format.empty() )
     {
-        cap.open( argv[1] );
+        frame_source = new RawYUVFileSource( source, raw_yuv_size, raw_yuv_format == "nv12" ? FramePyramid::GECKO_FORMAT_NV12
+                                                                                             : FramePyramid::GECKO_FORMAT_YUYV );
+    }
+    else if ( !source.empty() )
+    {
+        cap.open( source );
     }
     else
     {
@@ -56,7 +114,7 @@ int main( int argc, char * argv[] )
     }
 
     //-- Check if open
-    if ( !cap.isOpened() )
+    if ( frame_source ? !frame_source->isOpened() : !cap.isOpened() )
     {
         std::cerr << "Device could not be opened." << std::endl;
         return(1);
@@ -77,9 +135,20 @@ int main( int argc, char * argv[] )
 
     //-- To find the hand
     HandDetector handDetector;
+    handDetector.setAsyncFaceDetection( true );   //-- Live video: do not wait for the face detector
+    handDetector.loadBackground( BACKGROUND_FILE ); //-- Start from the background of the last run, if any
+    handDetector.setMaskFusion( 3, 2 );           //-- Skin must be seen in 2 of the last 3 frames
+    handDetector.setIlluminationNormalization( true ); //-- Follow the lighting changes of the scene
+    handDetector.setMotionThreshold( motion_gate );  //-- Reuse the last mask on static frames, if enabled
 
     //-- Object that will store the parameters of the hand
     HandDescriptor hand_descriptor;
+    hand_descriptor.setMirrored( true );          //-- Frames are processed unflipped, but shown as a mirror
+
+    //-- Several hands: each one is tracked with its own descriptor
+    HandsManager hands_manager( max_hands );
+    hands_manager.setMirrored( true );
+    handDetector.setMaxHands( max_hands );
 
     //-- State machine for tracking the cursor
     StateMachine cursor_SM( HandDescriptor::GECKO_GESTURE_OPEN_PALM, 3, 5);
@@ -92,11 +161,25 @@ int main( int argc, char * argv[] )
 
 
 
+    //-- Calibration profile: start straight away if there is a valid one
+    //---------------------------------------------------------------------
+    bool calibrated = !profile_file.empty() && handDetector.loadProfile( profile_file );
+    if ( calibrated )
+        handDetector.setSkinAdaptation( true );
+
+    //-- The calibration screens need BGR frames
+    if ( !calibrated && frame_source )
+    {
+        std::cerr << "Raw YUV sources need a calibration profile (--profile)." << std::endl;
+        return(1);
+    }
+
+
     //-- Initial screen
     //---------------------------------------------------------------------
     cv::Mat init_screen=cv::imread("../img/init.png");
 
-    while (1)
+    while ( !calibrated )
     {
         cv::imshow("GECKO", init_screen);
         char key =  cv::waitKey(delay);
@@ -113,7 +196,7 @@ int main( int argc, char * argv[] )
     //-- Menu
 
     cv::Mat menu=cv::imread("../img/menu.png");
-    while (1)
+    while ( !calibrated )
     {
         cv::imshow("MENU", menu);
         //-- Wait for user confirmation
@@ -122,10 +205,25 @@ int main( int argc, char * argv[] )
         {
             cv::destroyWindow("MENU");
             if (key=='1')
+            {
                 handDetector.defaultValues(cap);
+
+                //-- The HSV box is tuned on the default values screen, the other ones are fixed
+                if ( skin_box == "ycrcb" )
+                    handDetector.setSkinModel( HandDetector::GECKO_SKIN_MODEL_YCRCB_BOX );
+                else if ( skin_box == "rg" )
+                    handDetector.setSkinModel( HandDetector::GECKO_SKIN_MODEL_RG_BOX );
+                else if ( skin_box == "bgr" )
+                    handDetector.setSkinModel( HandDetector::GECKO_SKIN_MODEL_BGR_BOX );
+            }
             else if (key=='2')
                 handDetector.customValues(cap);
 
+            handDetector.setSkinAdaptation( true ); //-- Only used by the skin histogram of the custom values
+
+            if ( !save_profile_file.empty() )
+                handDetector.saveProfile( save_profile_file );
+
             break;
         }
         else if (key==27 || key=='q')
@@ -135,8 +233,14 @@ int main( int argc, char * argv[] )
 
 
 
+    //-- Frames of the main loop, in the format of the camera if asked for
+    if ( !frame_source )
+        frame_source = new CaptureFrameSource( cap, native_yuv, processing_size );
+
+
     //-- Main loop
     //--------------------------------------------------------------------
+    cv::Mat processed; //-- Segmentation buffer, reused by every frame
     stop = false;
     while(!stop)
     {
@@ -144,17 +248,18 @@ int main( int argc, char * argv[] )
         //-- Get current frame
         //-------------------------------------------------------------------------------------------------------
         cv::Mat frame, display;
-        if ( ! cap.read( frame ) )
+        if ( ! frame_source->read( frame ) )
             break;
+
+        handDetector.setFrameFormat( frame_source->getFormat() );
+        cv::Size frame_size = frame_source->getFormat() == FramePyramid::GECKO_FORMAT_NV12 ? cv::Size( frame.cols, frame.rows * 2 / 3 )
+                                                                                          : frame.size();
             //frame = cv::imread("../data/hand1.jpg");
             //frame = cv::imread( "../data/3dedos.jpg");
 
-        cv::flip(frame,frame,1);
-
         //------------------------------------------------------------------------------------------------------
         //-- Process it
         //------------------------------------------------------------------------------------------------------
-        cv::Mat processed;
 //        switch( debugValue )
 //        {
 //        case 0: case 2:
@@ -172,39 +277,65 @@ int main( int argc, char * argv[] )
 //            break;
 //        }
 
+        //-- Look for the hands only around their predicted positions (full frame if lost)
+        if ( max_hands > 1 )
+            handDetector.setSearchWindow( hands_manager.getSearchWindow( frame_size ) );
+        else
+            handDetector.setSearchWindow( hand_descriptor.getSearchWindow( frame_size ) );
         handDetector(frame, processed);
 
         //-- Contour extraction
-        hand_descriptor( processed );
+        if ( !handDetector.frameSkipped() ) //-- Static frame: keep the last hand
+        {
+            if ( max_hands > 1 )
+                hands_manager( processed, handDetector.getHandBoxes() );
+            else
+                hand_descriptor( processed, handDetector.getHandBox() );
+        }
+
+        //-- Commands follow a single hand: with several, the one tracked for longest
+        //-- (hand_descriptor is not updated then, so it stands for "no hand")
+        int primary_index = max_hands > 1 ? hands_manager.getPrimaryHand() : -1;
+        HandDescriptor& primary_hand = primary_index >= 0 ? hands_manager.getHand( primary_index ) : hand_descriptor;
+
+        //-- Follow the lighting changes with the skin of the recognized hands
+        if ( !handDetector.frameSkipped() && primary_hand.handFound()
+             && primary_hand.getGesture() != HandDescriptor::GECKO_GESTURE_NONE )
+            handDetector.adaptSkin( frame, primary_hand.getContours()[0] );
 
 
         //-- Hand's angle
-        std::cout << "[" << hand_descriptor.getHandAngle() << "]" << std::endl;
+        std::cout << "[" << primary_hand.getHandAngle() << "]" << std::endl;
 
 
         //--------------------------------------------------------------------------------------------------
         //-- Plot things on the image
         //--------------------------------------------------------------------------------------------------
+        //-- Mirror view: the only flip of the frame, the plots are mirrored by the hand descriptor
+        //-- (YUV frames are only converted to BGR here, for display)
         if ( display.total() == 0)
-            display = frame.clone();
+            cv::flip( handDetector.getPyramid().bgr( FramePyramid::GECKO_LEVEL_FULL ), display, 1 );
 
 
         //-- Plot hand interface
         //--------------------------------------------
-        hand_descriptor.plotHandInterface(display, display);
+        if ( max_hands > 1 )
+            hands_manager.plotHandInterface(display, display);
+        else
+            hand_descriptor.plotHandInterface(display, display);
 
 
         //-- Show gesture marker
         //-------------------------------------------
         cv::Scalar color;
         int fill = CV_FILLED;
-        if ( hand_descriptor.getGesture() == HandDescriptor::GECKO_GESTURE_OPEN_PALM )
+        if ( primary_hand.getGesture() == HandDescriptor::GECKO_GESTURE_OPEN_PALM )
             color = cv::Scalar( 255, 0, 0);
-        else if (hand_descriptor.getGesture() == HandDescriptor::GECKO_GESTURE_VICTORY)
+        else if (primary_hand.getGesture() == HandDescriptor::GECKO_GESTURE_VICTORY)
             color = cv::Scalar( 0, 255, 0);
-        else if (hand_descriptor.getGesture() == HandDescriptor::GECKO_GESTURE_GUN)
+        else if (primary_hand.getGesture() == HandDescriptor::GECKO_GESTURE_GUN)
             color = color = cv::Scalar( 0, 0, 255);
-        else if (hand_descriptor.getGesture() == HandDescriptor::GECKO_GESTURE_CLOSED_FIST)
+        else if (primary_hand.getGesture() == HandDescriptor::GECKO_GESTURE_CLOSED_FIST)
             color = cv::Scalar(255, 255, 255);
         else
         {
@@ -213,7 +344,7 @@ int main( int argc, char * argv[] )
         }
 
 
-        if ( hand_descriptor.handFound() )
+        if ( primary_hand.handFound() )
         {
             cv::circle( display, cv::Point( display.cols - 50, display.rows - 25 ), 7.5, color, fill );
         }
@@ -239,7 +370,7 @@ int main( int argc, char * argv[] )
             break;
 
         }
-        ss << " Angle: " <<hand_descriptor.getHandAngle()<< "";
+        ss << " Angle: " <<primary_hand.getHandAngle()<< "";
         std::string text = ss.str();
         cv::putText( display, text.c_str(), cv::Point(0, 18),
                      cv::FONT_HERSHEY_SIMPLEX, 0.33, cv::Scalar(0, 0, 255));
@@ -247,24 +378,24 @@ int main( int argc, char * argv[] )
 
         //-- Show detected faces
         //--------------------------------------------
-        handDetector.drawFaceMarks( display, display );
+        handDetector.drawFaceMarks( display, display, cv::Scalar(0, 255, 0), 1, true );
 
 
         //-----------------------------------------------------------------------------------------------------
         //-- Command mode actions
         //-----------------------------------------------------------------------------------------------------
-        if ( debugValue == 2 && hand_descriptor.handFound() )
+        if ( debugValue == 2 && primary_hand.handFound() )
         {
             //-- Move Cursor
             //-----------------------------------------------------------------------------------------------------
 
             //-- Check the state machine
-            cursor_SM.update( hand_descriptor.getGesture() );
+            cursor_SM.update( primary_hand.getGesture() );
 
             if ( cursor_SM.getFound() )
             {
                 //-- Show hand center of screen
-                hand_descriptor.plotCenter( display, display );
+                primary_hand.plotCenter( display, display );
 
                 //-- Calculate relative position and move there:
                 const int border = 50; //-- Leave a 50 px border around image
@@ -272,7 +403,7 @@ int main( int argc, char * argv[] )
 //                cv::Point win_down_right = cv::Point( display.cols - border, display.rows - border);
 //                cv::rectangle( display, win_up_left, win_down_right, cv::Scalar(255,255,255), 2);
 
-                cv::Point hand_center = hand_descriptor.getCenterHandEstimated();
+                cv::Point hand_center = primary_hand.getCenterHandEstimated();
 
                 std::pair< float, float> relativeCoordinates;
 
@@ -285,8 +416,8 @@ int main( int argc, char * argv[] )
                 //relativeCoordinates.first = hand_center.x /  (double) frame.cols;
                 //relativeCoordinates.second= hand_center.y / (double) frame.rows;
 
-                relativeCoordinates.first = (hand_center.x - border) /  (double)( frame.cols - 2 * border);
-                relativeCoordinates.second = (hand_center.y - border) /  (double)( frame.rows - 2 * border);
+                relativeCoordinates.first = (hand_center.x - border) /  (double)( frame_size.width - 2 * border);
+                relativeCoordinates.second = (hand_center.y - border) /  (double)( frame_size.height - 2 * border);
 
                 moveMousePercentage( relativeCoordinates );
             }
@@ -298,7 +429,7 @@ int main( int argc, char * argv[] )
             //-- Click action:
             //---------------------------------------------------------------------------------------------------
             //-- Check the state machine
-            click_SM.update( hand_descriptor.getGesture() );
+            click_SM.update( primary_hand.getGesture() );
 
             if ( click_SM.getFound() )
             {
@@ -314,7 +445,7 @@ int main( int argc, char * argv[] )
             //----------------------------------------------------------------------------------------------------
 
             //-- Update the launcher state machines
-            launcher.update( hand_descriptor.getGesture() );
+            launcher.update( primary_hand.getGesture() );
 
             for (int i = 0; i < launcher.getNumberOfCommands(); i++)
                 if ( !launcher.getFound(i) && launcher.getPercentageMatches(i) != 0)
@@ -336,7 +467,7 @@ int main( int argc, char * argv[] )
         //-----------------------------------------------------------------------------------------------------
         //-- Show angle gauge
         //----------------------------------------------------------------------------------------------------
-        hand_descriptor.angleControl();
+        primary_hand.angleControl();
 
 
         //-----------------------------------------------------------------------------------------------------
@@ -369,5 +500,12 @@ int main( int argc, char * argv[] )
         }
     }
 
+    handDetector.saveBackground( BACKGROUND_FILE );
+    delete frame_source;
+
+    if ( motion_gate > 0 )
+        std::cout << "Frames processed: " << handDetector.getProcessedFrames()
+                  << ", skipped as static: " << handDetector.getSkippedFrames() << std::endl;
+
     return 0;
 }
@@ -25,23 +25,35 @@
  */
 
 #include <iostream>
+#include <cstdio>
 #include <opencv2/opencv.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include "HandDetector.h"
 #include "HandDescriptor.h"
+#include "jpegDecoder.h"
 
 int main( int argc, char * argv[] )
 {
+    //-- JPEG images can be scaled down while decoding, if they are processed at a lower resolution
+    cv::Size processing_size;
+    if ( argc > 2 && std::string( argv[1] ) == "--processing-size" )
+    {
+        sscanf( argv[2], "%dx%d", &processing_size.width, &processing_size.height );
+        argc -= 2;
+        argv += 2;
+    }
+
     if ( argc < 2)
     {
-        std::cout << "Gecko - Gesture Recognition\n\nUsage: gecko_image_analyzer <image> <image to save>(optional)\n" << std::endl;
+        std::cout << "Gecko - Gesture Recognition\n\nUsage: gecko_image_analyzer [--processing-size <width>x<height>] <image> <image to save>(optional)\n" << std::endl;
         return -1;
     }
 
     //-- Load image from file
     std::cout << "Opening " << cv::String(argv[1]) << std::endl;
-    cv::Mat image = cv::imread( cv::String(argv[1]), CV_LOAD_IMAGE_COLOR);
+    cv::Mat image;
+    readImage( std::string(argv[1]), processing_size, image );
     cv::Mat processed;
     cv::Mat display;
 
@@ -56,7 +68,7 @@ int main( int argc, char * argv[] )
     handDetector(image, processed);
 
     //-- Contour extraction
-    hand_descriptor( processed );
+    hand_descriptor( processed, handDetector.getHandBox() );
 
 
     //-- Hand's angle
@@ -44,6 +44,26 @@ bool gecko::GeckoModule::configure(yarp::os::ResourceFinder &rf)
          }
     }
 
+    //-- This restores the background learnt on the last run
+    backgroundFile = "background.model";
+    if (rf.check("background"))
+        backgroundFile = rf.find("background").asString();
+    handDetector.loadBackground(backgroundFile);
+
+    //-- This loads a skin calibration saved by gecko (--save-profile)
+    if (rf.check("profile"))
+        handDetector.loadProfile(rf.find("profile").asString());
+
+    //-- This lets the skin model (if learnt from the user's skin) follow the lighting
+    handDetector.setSkinAdaptation(rf.check("adaptSkin"));
+
+    //-- This normalizes the frames to the lighting of the calibration
+    handDetector.setIlluminationNormalization(rf.check("normalizeLighting"));
+
+    //-- This reuses the last segmentation while less than this fraction of the pixels changes
+    if (rf.check("motionGate"))
+        handDetector.setMotionThreshold(rf.find("motionGate").asDouble());
+
     return openPorts();
 }
 
@@ -68,7 +88,7 @@ void gecko::GeckoModule::onRead(gecko::Image &src)
     cv::Mat frame(cvImage);
 
     //-- Hand segmentation
-    cv::Mat processed;
+    handDetector.setSearchWindow( handDescriptor.getSearchWindow( frame.size() ) );
     handDetector(frame, processed);
 
     //-- Send back segmentation image if debug is enabled
@@ -84,7 +104,13 @@ void gecko::GeckoModule::onRead(gecko::Image &src)
     }
 
     //-- Descriptor extraction
-    handDescriptor( processed );
+    if ( !handDetector.frameSkipped() ) //-- Static frame: keep the last hand
+        handDescriptor( processed, handDetector.getHandBox() );
+
+    //-- Follow the lighting changes with the skin of the recognized hands
+    if ( !handDetector.frameSkipped() && handDescriptor.handFound()
+         && handDescriptor.getGesture() != HandDescriptor::GECKO_GESTURE_NONE )
+        handDetector.adaptSkin( frame, handDescriptor.getContours()[0] );
 
     if(handDescriptor.handFound())
     {
@@ -135,6 +161,9 @@ void gecko::GeckoModule::onRead(gecko::Image &src)
 
 bool gecko::GeckoModule::close()
 {
+    handDetector.saveBackground(backgroundFile);
+    CD_INFO("Frames processed: %ld, skipped as static: %ld\n", handDetector.getProcessedFrames(),
+            handDetector.getSkippedFrames());
     return closePorts();
 }
 
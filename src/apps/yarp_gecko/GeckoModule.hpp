@@ -84,9 +84,14 @@ class GeckoModule : public yarp::os::RFModule, public yarp::os::TypedReaderCallb
         bool connectInput;
         std::string rgbStreamPort;
 
+        std::string backgroundFile;
+
         HandDetector handDetector;
         HandDescriptor handDescriptor;
 
+        //-- Segmentation of the last image, kept to reuse its buffer
+        cv::Mat processed;
+
 };
 
 }  // namespace gecko
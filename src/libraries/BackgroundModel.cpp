@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+//-- BackgroundModel
+//------------------------------------------------------------------------------
+//--
+//-- Interface of the background models used to find the foreground
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file BackgroundModel.cpp
+ *  \brief Interface of the background models used to find the foreground
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "BackgroundModel.h"
+#include <cstring>
+
+//-- Every snapshot starts with this, followed by the tag of the model
+static const char SNAPSHOT_MAGIC[] = "GKBG";
+static const int TAG_LENGTH = 4;
+
+//-- Limits of the images of a snapshot (a full HD MOG2 model with 5 mixtures takes about 200 MB)
+static const int MAX_SIDE = 1 << 16;
+static const size_t MAX_IMAGE_BYTES = (size_t) 1 << 28;
+
+void BackgroundModel::writeMat(std::ostream &out, const cv::Mat &image)
+{
+    int header[3] = { image.rows, image.cols, image.type() };
+    out.write( (const char *) header, sizeof(header) );
+
+    const size_t row_size = image.cols * image.elemSize();
+    for ( int i = 0; i < image.rows; i++ )
+        out.write( (const char *) image.ptr( i ), row_size );
+}
+
+bool BackgroundModel::readMat(std::istream &in, cv::Mat &image, int type)
+{
+    int header[3];
+    if ( !in.read( (char *) header, sizeof(header) ) )
+        return false;
+
+    //-- Reject types and sizes that cannot come from a model, before allocating anything:
+    if ( header[2] != type || header[0] < 0 || header[1] < 0 || header[0] > MAX_SIDE || header[1] > MAX_SIDE )
+        return false;
+
+    size_t bytes = (size_t) header[0] * header[1] * CV_ELEM_SIZE( type );
+    if ( bytes > MAX_IMAGE_BYTES )
+        return false;
+
+    //-- A truncated file would be allocated for nothing:
+    std::streampos position = in.tellg();
+    if ( position != std::streampos( -1 ) && in.seekg( 0, std::ios::end ) )
+    {
+        std::streamoff remaining = in.tellg() - position;
+        in.seekg( position );
+        if ( remaining < (std::streamoff) bytes )
+            return false;
+    }
+    in.clear();
+
+    image.create( header[0], header[1], type );
+
+    const size_t row_size = image.cols * image.elemSize();
+    for ( int i = 0; i < image.rows; i++ )
+        if ( !in.read( (char *) image.ptr( i ), row_size ) )
+            return false;
+
+    return true;
+}
+
+void BackgroundModel::writeTag(std::ostream &out, const char *tag)
+{
+    out.write( SNAPSHOT_MAGIC, TAG_LENGTH );
+    out.write( tag, TAG_LENGTH );
+}
+
+bool BackgroundModel::readTag(std::istream &in, const char *tag)
+{
+    char read[2 * TAG_LENGTH];
+    if ( !in.read( read, sizeof(read) ) )
+        return false;
+
+    return strncmp( read, SNAPSHOT_MAGIC, TAG_LENGTH ) == 0 && strncmp( read + TAG_LENGTH, tag, TAG_LENGTH ) == 0;
+}
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+//-- BackgroundModel
+//------------------------------------------------------------------------------
+//--
+//-- Interface of the background models used to find the foreground
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file BackgroundModel.h
+ *  \brief Interface of the background models used to find the foreground
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef BACKGROUNDMODEL_H
+#define BACKGROUNDMODEL_H
+
+#include <string>
+#include <iostream>
+#include <opencv2/opencv.hpp>
+
+
+/*! \class BackgroundModel
+ *  \brief Interface of the background models used to find the foreground
+ *
+ *  Implementations learn the background from the frames they are given, and classify each pixel of
+ *  those frames as background or foreground.
+ */
+class BackgroundModel
+{
+    public:
+        virtual ~BackgroundModel() {}
+
+        /*! \brief Updates the model with a frame and finds its foreground
+         *  \param frame BGR image (CV_8UC3)
+         *  \param foreground Binary output image (CV_8UC1), non-zero for foreground pixels
+         */
+        virtual void apply( const cv::Mat& frame, cv::Mat& foreground ) = 0;
+
+        //! \brief Returns the current estimation of the background (BGR, empty if nothing was learnt)
+        virtual void getBackgroundImage( cv::Mat& background ) = 0;
+
+        /*! \brief Writes the state of the model to a binary file, to restore it on the next run
+         *  \return False if the file could not be written
+         */
+        virtual bool save( const std::string& file ) = 0;
+
+        /*! \brief Restores the state of the model from a file written by save()
+         *  \return False if the file could not be read or was written by a different kind of model
+         */
+        virtual bool load( const std::string& file ) = 0;
+
+    protected:
+        //! \brief Writes the size, type and pixels of an image to a binary stream
+        static void writeMat( std::ostream& out, const cv::Mat& image );
+
+        /*! \brief Reads an image written by writeMat()
+         *
+         *  Nothing is allocated unless the header has the expected type, a size that fits in the snapshot
+         *  limits, and the stream holds all its pixels.
+         *
+         *  \param type Expected type of the image
+         *  \return False on error, or if the image is not of the expected type
+         */
+        static bool readMat( std::istream& in, cv::Mat& image, int type );
+
+        //! \brief Writes the tag that identifies the kind of model that wrote a file
+        static void writeTag( std::ostream& out, const char * tag );
+
+        //! \brief Reads a tag and checks that it matches the expected one
+        static bool readTag( std::istream& in, const char * tag );
+};
+
+#endif // BACKGROUNDMODEL_H
@@ -0,0 +1,318 @@
+//------------------------------------------------------------------------------
+//-- BitMask
+//------------------------------------------------------------------------------
+//--
+//-- Binary image with one bit per pixel
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file BitMask.cpp
+ *  \brief Binary image with one bit per pixel
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "BitMask.h"
+#include <algorithm>
+
+static const int WORD_BITS = 64;
+
+BitMask::BitMask()
+{
+    rows = cols = words_per_row = 0;
+}
+
+BitMask::BitMask(int rows, int cols)
+{
+    create( rows, cols );
+    setTo( false );
+}
+
+void BitMask::create(int rows, int cols)
+{
+    this->rows = rows;
+    this->cols = cols;
+    words_per_row = ( cols + WORD_BITS - 1 ) / WORD_BITS;
+    data.resize( (size_t) rows * words_per_row );
+}
+
+int BitMask::getRows() const
+{
+    return rows;
+}
+
+int BitMask::getCols() const
+{
+    return cols;
+}
+
+int BitMask::getWordsPerRow() const
+{
+    return words_per_row;
+}
+
+uint64_t * BitMask::row(int i)
+{
+    return &data[ (size_t) i * words_per_row ];
+}
+
+const uint64_t * BitMask::row(int i) const
+{
+    return &data[ (size_t) i * words_per_row ];
+}
+
+bool BitMask::get(int i, int j) const
+{
+    return ( row( i )[ j / WORD_BITS ] >> ( j % WORD_BITS ) ) & 1;
+}
+
+void BitMask::setTo(bool value)
+{
+    std::fill( data.begin(), data.end(), value ? ~(uint64_t) 0 : 0 );
+    clearPadding();
+}
+
+void BitMask::setTo(const cv::Rect &rect, bool value)
+{
+    cv::Rect r = rect & cv::Rect( 0, 0, cols, rows );
+    if ( r.area() == 0 )
+        return;
+
+    int first = r.x / WORD_BITS, last = ( r.x + r.width - 1 ) / WORD_BITS;
+    uint64_t first_mask = ~(uint64_t) 0 << ( r.x % WORD_BITS );
+    uint64_t last_mask = ~(uint64_t) 0 >> ( WORD_BITS - 1 - ( r.x + r.width - 1 ) % WORD_BITS );
+
+    for ( int i = r.y; i < r.y + r.height; i++ )
+    {
+        uint64_t * w = row( i );
+
+        for ( int k = first; k <= last; k++ )
+        {
+            uint64_t bits = ~(uint64_t) 0;
+            if ( k == first ) bits &= first_mask;
+            if ( k == last ) bits &= last_mask;
+
+            w[k] = value ? w[k] | bits : w[k] & ~bits;
+        }
+    }
+}
+
+void BitMask::fromMat(const cv::Mat &mask)
+{
+    CV_Assert( mask.type() == CV_8UC1 );
+    create( mask.rows, mask.cols );
+
+    for ( int i = 0; i < rows; i++ )
+    {
+        const uchar * m = mask.ptr<uchar>( i );
+        uint64_t * w = row( i );
+
+        for ( int k = 0; k < words_per_row; k++ )
+        {
+            int end = std::min( cols - k * WORD_BITS, WORD_BITS );
+            uint64_t word = 0;
+
+            for ( int b = 0; b < end; b++ )
+                word |= (uint64_t) ( m[ k * WORD_BITS + b ] != 0 ) << b;
+
+            w[k] = word;
+        }
+    }
+}
+
+void BitMask::toMat(cv::Mat &mask) const
+{
+    mask.create( rows, cols, CV_8UC1 );
+
+    for ( int i = 0; i < rows; i++ )
+    {
+        uchar * m = mask.ptr<uchar>( i );
+        const uint64_t * w = row( i );
+
+        for ( int j = 0; j < cols; j++ )
+            m[j] = ( w[ j / WORD_BITS ] >> ( j % WORD_BITS ) ) & 1 ? 255 : 0;
+    }
+}
+
+void BitMask::copyTo(BitMask &dst, const cv::Point &offset) const
+{
+    CV_Assert( offset.x >= 0 && offset.y >= 0 && offset.x + cols <= dst.cols && offset.y + rows <= dst.rows );
+
+    //-- Each source word spans at most two destination words:
+    int base = offset.x / WORD_BITS;
+    int shift = offset.x % WORD_BITS;
+
+    for ( int i = 0; i < rows; i++ )
+    {
+        const uint64_t * s = row( i );
+        uint64_t * d = dst.row( offset.y + i );
+
+        for ( int k = 0; k < words_per_row; k++ )
+        {
+            uint64_t valid = k == words_per_row - 1 ? lastWordMask() : ~(uint64_t) 0;
+
+            d[ base + k ] = ( d[ base + k ] & ~( valid << shift ) ) | ( s[k] << shift );
+
+            if ( shift && base + k + 1 < dst.words_per_row )
+                d[ base + k + 1 ] = ( d[ base + k + 1 ] & ~( valid >> ( WORD_BITS - shift ) ) )
+                                    | ( s[k] >> ( WORD_BITS - shift ) );
+        }
+    }
+}
+
+void BitMask::copyFrom(const BitMask &src, const cv::Rect &roi)
+{
+    CV_Assert( roi.x >= 0 && roi.y >= 0 && roi.x + roi.width <= src.cols && roi.y + roi.height <= src.rows );
+    create( roi.height, roi.width );
+
+    int base = roi.x / WORD_BITS;
+    int shift = roi.x % WORD_BITS;
+
+    for ( int i = 0; i < rows; i++ )
+    {
+        const uint64_t * s = src.row( roi.y + i );
+        uint64_t * d = row( i );
+
+        for ( int k = 0; k < words_per_row; k++ )
+        {
+            uint64_t word = s[ base + k ] >> shift;
+            if ( shift && base + k + 1 < src.words_per_row )
+                word |= s[ base + k + 1 ] << ( WORD_BITS - shift );
+
+            d[k] = word;
+        }
+    }
+
+    clearPadding();
+}
+
+size_t BitMask::count() const
+{
+    size_t total = 0;
+    for ( size_t k = 0; k < data.size(); k++ )
+        total += __builtin_popcountll( data[k] );
+
+    return total;
+}
+
+void BitMask::bitwiseAnd(const BitMask &a, const BitMask &b, BitMask &dst)
+{
+    CV_Assert( a.rows == b.rows && a.cols == b.cols );
+    dst.create( a.rows, a.cols );
+
+    for ( size_t k = 0; k < a.data.size(); k++ )
+        dst.data[k] = a.data[k] & b.data[k];
+}
+
+void BitMask::bitwiseOr(const BitMask &a, const BitMask &b, BitMask &dst)
+{
+    CV_Assert( a.rows == b.rows && a.cols == b.cols );
+    dst.create( a.rows, a.cols );
+
+    for ( size_t k = 0; k < a.data.size(); k++ )
+        dst.data[k] = a.data[k] | b.data[k];
+}
+
+void BitMask::bitwiseNot(const BitMask &src, BitMask &dst)
+{
+    dst.create( src.rows, src.cols );
+
+    for ( size_t k = 0; k < src.data.size(); k++ )
+        dst.data[k] = ~src.data[k];
+
+    dst.clearPadding();
+}
+
+void BitMask::erode(BitMask &dst) const
+{
+    morphology( dst, true );
+}
+
+void BitMask::dilate(BitMask &dst) const
+{
+    morphology( dst, false );
+}
+
+void BitMask::morphology(BitMask &dst, bool erode) const
+{
+    CV_Assert( &dst != this );
+    dst.create( rows, cols );
+
+    const uint64_t outside = erode ? ~(uint64_t) 0 : 0;    //-- Value of the pixels outside the mask
+    const uint64_t padding = ~lastWordMask();
+
+    //-- Horizontal pass: each pixel with its left and right neighbours
+    //---------------------------------------------------------------------------
+    for ( int i = 0; i < rows; i++ )
+    {
+        const uint64_t * w = row( i );
+        uint64_t * h = dst.row( i );
+
+        for ( int k = 0; k < words_per_row; k++ )
+        {
+            //-- Padding bits behave as pixels outside the mask:
+            uint64_t center = k == words_per_row - 1 ? w[k] | ( outside & padding ) : w[k];
+            uint64_t previous = k > 0 ? w[k-1] : outside;
+            uint64_t next = k + 1 < words_per_row ? w[k+1] : outside;
+            if ( k + 1 == words_per_row - 1 )
+                next |= outside & padding;
+
+            uint64_t left = ( center << 1 ) | ( previous >> ( WORD_BITS - 1 ) );
+            uint64_t right = ( center >> 1 ) | ( next << ( WORD_BITS - 1 ) );
+
+            h[k] = erode ? center & left & right : center | left | right;
+        }
+    }
+
+    //-- Vertical pass, in place, keeping the previous horizontal row:
+    //---------------------------------------------------------------------------
+    dst.scratch.resize( 2 * words_per_row );
+    uint64_t * above = &dst.scratch[0];
+    uint64_t * current = &dst.scratch[words_per_row];
+    std::fill( above, above + words_per_row, outside );
+
+    for ( int i = 0; i < rows; i++ )
+    {
+        uint64_t * h = dst.row( i );
+        const uint64_t * below = i + 1 < rows ? dst.row( i + 1 ) : NULL;
+
+        std::copy( h, h + words_per_row, current );
+
+        for ( int k = 0; k < words_per_row; k++ )
+        {
+            uint64_t b = below ? below[k] : outside;
+            h[k] = erode ? above[k] & current[k] & b : above[k] | current[k] | b;
+        }
+
+        std::swap( above, current );
+    }
+
+    dst.clearPadding();
+}
+
+uint64_t BitMask::lastWordMask() const
+{
+    int used = cols % WORD_BITS;
+    return used == 0 ? ~(uint64_t) 0 : ( (uint64_t) 1 << used ) - 1;
+}
+
+void BitMask::clearPadding()
+{
+    if ( words_per_row == 0 )
+        return;
+
+    const uint64_t valid = lastWordMask();
+    for ( int i = 0; i < rows; i++ )
+        row( i )[ words_per_row - 1 ] &= valid;
+}
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+//-- BitMask
+//------------------------------------------------------------------------------
+//--
+//-- Binary image with one bit per pixel
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file BitMask.h
+ *  \brief Binary image with one bit per pixel
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef BITMASK_H
+#define BITMASK_H
+
+#include <vector>
+#include <stdint.h>
+#include <opencv2/opencv.hpp>
+
+
+/*! \class BitMask
+ *  \brief Binary image with one bit per pixel
+ *
+ *  Each row is stored in 64 bit words, the pixel at column j being bit j % 64 of word j / 64. The
+ *  bits past the last column are always zero. Logic operations, morphology and counting work on
+ *  whole words, i.e. on 64 pixels at a time, and move 8 times less memory than a CV_8UC1 mask.
+ *
+ *  Masks are converted from / to cv::Mat only where an OpenCV function needs them.
+ */
+class BitMask
+{
+    public:
+        //! \brief Creates an empty mask
+        BitMask();
+
+        //! \brief Creates a mask of the given size, all zeros
+        BitMask( int rows, int cols );
+
+        //! \brief Sets the size of the mask, reusing the memory if possible. Contents are undefined
+        void create( int rows, int cols );
+
+        //! \brief Returns the number of rows
+        int getRows() const;
+        //! \brief Returns the number of columns
+        int getCols() const;
+        //! \brief Returns the number of words of each row
+        int getWordsPerRow() const;
+
+        //! \brief Returns a pointer to the words of a row
+        uint64_t * row( int i );
+        //! \brief Returns a pointer to the words of a row
+        const uint64_t * row( int i ) const;
+
+        //! \brief Returns the value of a pixel
+        bool get( int i, int j ) const;
+
+        //! \brief Sets all the pixels to a value
+        void setTo( bool value );
+
+        //! \brief Sets the pixels inside a rectangle (clipped to the mask) to a value
+        void setTo( const cv::Rect& rect, bool value );
+
+        //! \brief Builds the mask from a CV_8UC1 image (non-zero pixels are set)
+        void fromMat( const cv::Mat& mask );
+
+        //! \brief Converts the mask to a CV_8UC1 image (0 / 255)
+        void toMat( cv::Mat& mask ) const;
+
+        //! \brief Writes this mask into a region of a larger one, whose top left corner is at offset (the rest of dst is kept)
+        void copyTo( BitMask& dst, const cv::Point& offset ) const;
+
+        //! \brief Makes this mask a copy of a region of another one
+        void copyFrom( const BitMask& src, const cv::Rect& roi );
+
+        //! \brief Returns the number of pixels set
+        size_t count() const;
+
+        //! \brief Pixelwise AND (dst may be one of the inputs)
+        static void bitwiseAnd( const BitMask& a, const BitMask& b, BitMask& dst );
+        //! \brief Pixelwise OR (dst may be one of the inputs)
+        static void bitwiseOr( const BitMask& a, const BitMask& b, BitMask& dst );
+        //! \brief Pixelwise NOT (dst may be src)
+        static void bitwiseNot( const BitMask& src, BitMask& dst );
+
+        //! \brief Erodes the mask with a 3x3 square (pixels outside the mask count as set). dst must not be this mask
+        void erode( BitMask& dst ) const;
+
+        //! \brief Dilates the mask with a 3x3 square (pixels outside the mask count as clear). dst must not be this mask
+        void dilate( BitMask& dst ) const;
+
+    private:
+        //! \brief 3x3 morphology: AND of the neighbourhood if erode, OR otherwise
+        void morphology( BitMask& dst, bool erode ) const;
+
+        //! \brief Clears the bits past the last column
+        void clearPadding();
+
+        //! \brief Returns the valid bits of the last word of each row
+        uint64_t lastWordMask() const;
+
+        int rows;                           //!< \brief Number of rows
+        int cols;                           //!< \brief Number of columns
+        int words_per_row;                  //!< \brief Words used by each row
+        std::vector<uint64_t> data;         //!< \brief Pixels, row by row
+        std::vector<uint64_t> scratch;      //!< \brief Rows kept by the morphology operations
+};
+
+#endif // BITMASK_H
@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+//-- CaptureFrameSource
+//------------------------------------------------------------------------------
+//--
+//-- Frame source that reads from a cv::VideoCapture, in YUV if the camera allows it
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file CaptureFrameSource.cpp
+ *  \brief Frame source that reads from a cv::VideoCapture, in YUV if the camera allows it
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "CaptureFrameSource.h"
+#include "jpegDecoder.h"
+#include <iostream>
+
+//-- Max. number of corrupt frames skipped while waiting for the first frame that decodes
+static const int MAX_SKIPPED_CORRUPT_FRAMES = 100;
+
+CaptureFrameSource::CaptureFrameSource(cv::VideoCapture &capture, bool native_yuv, const cv::Size &processing_size)
+{
+    this->capture = capture;
+    this->native_yuv = native_yuv;
+    this->processing_size = processing_size;
+    format = FramePyramid::GECKO_FORMAT_BGR;
+    decoded_valid = false;
+    corrupt_frames = 0;
+
+    raw = native_yuv || processing_size.area() > 0;
+
+    if ( processing_size.area() > 0 )
+        this->capture.set( CV_CAP_PROP_FOURCC, CV_FOURCC( 'M', 'J', 'P', 'G' ) );
+
+    if ( raw )
+        this->capture.set( CV_CAP_PROP_CONVERT_RGB, 0 );
+}
+
+bool CaptureFrameSource::isOpened()
+{
+    return capture.isOpened();
+}
+
+bool CaptureFrameSource::read(cv::Mat &frame)
+{
+    if ( !capture.read( frame ) )
+        return false;
+
+    if ( frame.type() == CV_8UC3 )
+    {
+        format = FramePyramid::GECKO_FORMAT_BGR;
+        return true;
+    }
+
+    if ( native_yuv && frame.type() == CV_8UC2 )
+    {
+        format = FramePyramid::GECKO_FORMAT_YUYV;
+        return true;
+    }
+
+    //-- Compressed frames come as a buffer of bytes, and are decoded straight to the processing size:
+    for ( int skipped = 0; raw && frame.type() == CV_8UC1 && frame.isContinuous() && isJPEG( frame.data, frame.total() ); skipped++ )
+    {
+        format = FramePyramid::GECKO_FORMAT_BGR;
+
+        if ( decodeJPEG( frame.data, frame.total(), processing_size, decoded ) )
+            decoded_valid = true;
+        else
+            reportCorruptFrame();
+
+        //-- A corrupt frame keeps what could be decoded over the previous frame, but until a whole frame
+        //-- has been decoded there is nothing to keep, so the next one is read instead:
+        if ( decoded_valid )
+        {
+            frame = decoded;
+            return true;
+        }
+
+        if ( skipped == MAX_SKIPPED_CORRUPT_FRAMES || !capture.read( frame ) )
+            return false;
+    }
+
+    //-- Some backends give the raw buffer as a single row of bytes:
+    int width = capture.get( CV_CAP_PROP_FRAME_WIDTH );
+    int height = capture.get( CV_CAP_PROP_FRAME_HEIGHT );
+
+    if ( native_yuv && frame.type() == CV_8UC1 && frame.isContinuous() && width > 0 && height > 0 )
+    {
+        if ( (int) frame.total() == width * height * 2 )
+        {
+            frame = frame.reshape( 2, height );
+            format = FramePyramid::GECKO_FORMAT_YUYV;
+            return true;
+        }
+
+        if ( (int) frame.total() == width * height * 3 / 2 && height % 2 == 0 )
+        {
+            frame = frame.reshape( 1, height * 3 / 2 );
+            format = FramePyramid::GECKO_FORMAT_NV12;
+            return true;
+        }
+    }
+
+    std::cerr << "[Warning] Unknown frame layout, falling back to BGR frames" << std::endl;
+    disableRawFrames();
+
+    format = FramePyramid::GECKO_FORMAT_BGR;
+    return capture.read( frame ) && frame.type() == CV_8UC3;
+}
+
+unsigned int CaptureFrameSource::getFormat()
+{
+    return format;
+}
+
+void CaptureFrameSource::reportCorruptFrame()
+{
+    //-- Corrupt frames can be frequent, so only the 1st, 2nd, 4th, 8th... are reported:
+    corrupt_frames++;
+    if ( ( corrupt_frames & ( corrupt_frames - 1 ) ) == 0 )
+        std::cerr << "[Warning] " << corrupt_frames << " corrupt JPEG frame(s) so far" << std::endl;
+}
+
+void CaptureFrameSource::disableRawFrames()
+{
+    if ( raw )
+        capture.set( CV_CAP_PROP_CONVERT_RGB, 1 );
+
+    raw = false;
+    native_yuv = false;
+}
@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+//-- CaptureFrameSource
+//------------------------------------------------------------------------------
+//--
+//-- Frame source that reads from a cv::VideoCapture, in YUV if the camera allows it
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file CaptureFrameSource.h
+ *  \brief Frame source that reads from a cv::VideoCapture, in YUV if the camera allows it
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef CAPTUREFRAMESOURCE_H
+#define CAPTUREFRAMESOURCE_H
+
+#include "FrameSource.h"
+
+
+/*! \class CaptureFrameSource
+ *  \brief Frame source that reads from a cv::VideoCapture, in YUV if the camera allows it
+ *
+ *  When native YUV is requested, the conversion to BGR of the backend is disabled, and the raw frames
+ *  are taken as YUYV or NV12 depending on their layout. If the backend ignores the request, or gives
+ *  a layout that is not known, the source keeps delivering BGR frames.
+ *
+ *  When a processing size is given, the camera is asked for MJPEG, and the raw JPEG frames are decoded
+ *  here, scaled down in the DCT domain as far as the processing size allows (see decodeJPEG()).
+ */
+class CaptureFrameSource : public FrameSource
+{
+    public:
+        /*! \brief Creates the source
+         *  \param capture Opened capture (it is shared, not copied)
+         *  \param native_yuv If true, asks the backend for the frames in the format of the camera
+         *  \param processing_size Size the frames are processed at. If not empty, MJPEG frames are decoded
+         *  at the smallest DCT scaling that still reaches it
+         */
+        CaptureFrameSource( cv::VideoCapture& capture, bool native_yuv = false, const cv::Size& processing_size = cv::Size() );
+
+        bool isOpened();
+        bool read( cv::Mat& frame );
+        unsigned int getFormat();
+
+    private:
+        //! \brief Goes back to the BGR frames converted by the backend
+        void disableRawFrames();
+
+        //! \brief Counts a frame that could not be decoded, with a warning now and then
+        void reportCorruptFrame();
+
+        cv::VideoCapture capture;   //!< \brief Capture the frames are read from
+        bool native_yuv;            //!< \brief True if raw YUV frames are accepted
+        bool raw;                   //!< \brief True while the raw frames are requested
+        cv::Size processing_size;   //!< \brief Size the frames are processed at (empty for full size)
+        unsigned int format;        //!< \brief Format of the last frame read
+        cv::Mat decoded;            //!< \brief Buffer for the decoded JPEG frames
+        bool decoded_valid;         //!< \brief True once a JPEG frame has been decoded whole
+        long corrupt_frames;        //!< \brief Number of JPEG frames that could not be decoded
+};
+
+#endif // CAPTUREFRAMESOURCE_H
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+//-- ChannelStats
+//------------------------------------------------------------------------------
+//--
+//-- Per-channel statistics of 8 bit images, computed from their histograms
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file ChannelStats.cpp
+ *  \brief Per-channel statistics of 8 bit images, computed from their histograms
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "ChannelStats.h"
+#include <cmath>
+
+ChannelStats::ChannelStats(int channels)
+{
+    CV_Assert( channels >= 1 && channels <= 4 );
+    this->channels = channels;
+    reset();
+}
+
+void ChannelStats::reset()
+{
+    histograms.assign( channels, std::vector<long>( BINS, 0 ) );
+    count = 0;
+}
+
+void ChannelStats::accumulate(const cv::Mat &image, const cv::Mat &mask)
+{
+    CV_Assert( image.depth() == CV_8U && image.channels() == channels );
+    CV_Assert( mask.empty() || ( mask.type() == CV_8UC1 && mask.size() == image.size() ) );
+
+    //-- 32 bit counters for the pass (a row never overflows them), added to the totals at the end
+    std::vector<int> counts( channels * BINS, 0 );
+
+    for ( int i = 0; i < image.rows; i++ )
+    {
+        const uchar * p = image.ptr<uchar>( i );
+        const uchar * m = mask.empty() ? NULL : mask.ptr<uchar>( i );
+
+        for ( int j = 0; j < image.cols; j++, p += channels )
+        {
+            if ( m && !m[j] )
+                continue;
+
+            for ( int k = 0; k < channels; k++ )
+                counts[ k * BINS + p[k] ]++;
+            count++;
+        }
+
+        //-- Flush before the counters may overflow:
+        if ( ( i & 1023 ) == 1023 || i == image.rows - 1 )
+            for ( int k = 0; k < channels * BINS; k++ )
+            {
+                histograms[ k / BINS ][ k % BINS ] += counts[k];
+                counts[k] = 0;
+            }
+    }
+}
+
+int ChannelStats::getChannels() const
+{
+    return channels;
+}
+
+long ChannelStats::getCount() const
+{
+    return count;
+}
+
+const std::vector<long> &ChannelStats::getHistogram(int channel) const
+{
+    return histograms[channel];
+}
+
+long ChannelStats::getMaxBin(int channel) const
+{
+    long max_bin = 0;
+    for ( int i = 0; i < BINS; i++ )
+        max_bin = std::max( max_bin, histograms[channel][i] );
+
+    return max_bin;
+}
+
+int ChannelStats::median(int channel) const
+{
+    return median( histograms[channel], count );
+}
+
+int ChannelStats::mad(int channel) const
+{
+    if ( count == 0 )
+        return 0;
+
+    //-- Histogram of the absolute deviations, built from the histogram of the values:
+    int center = median( channel );
+    std::vector<long> deviations( BINS, 0 );
+    for ( int i = 0; i < BINS; i++ )
+        deviations[ std::abs( i - center ) ] += histograms[channel][i];
+
+    return median( deviations, count );
+}
+
+double ChannelStats::mean(int channel) const
+{
+    if ( count == 0 )
+        return 0;
+
+    double sum = 0;
+    for ( int i = 0; i < BINS; i++ )
+        sum += (double) i * histograms[channel][i];
+
+    return sum / count;
+}
+
+double ChannelStats::variance(int channel) const
+{
+    if ( count == 0 )
+        return 0;
+
+    double m = mean( channel );
+    double sum = 0;
+    for ( int i = 0; i < BINS; i++ )
+        sum += ( i - m ) * ( i - m ) * histograms[channel][i];
+
+    return sum / count;
+}
+
+double ChannelStats::stdDeviation(int channel) const
+{
+    return std::sqrt( variance( channel ) );
+}
+
+int ChannelStats::valueAt(const std::vector<long> &histogram, long rank)
+{
+    long seen = 0;
+    for ( int i = 0; i < BINS; i++ )
+    {
+        seen += histogram[i];
+        if ( seen > rank )
+            return i;
+    }
+
+    return BINS - 1;
+}
+
+int ChannelStats::median(const std::vector<long> &histogram, long count)
+{
+    if ( count == 0 )
+        return 0;
+
+    //-- Odd count: the central value. Even count: mean of the two central ones, rounded up
+    int lower = valueAt( histogram, ( count - 1 ) / 2 );
+    int upper = valueAt( histogram, count / 2 );
+    return ( lower + upper + 1 ) / 2;
+}
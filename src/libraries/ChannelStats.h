@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+//-- ChannelStats
+//------------------------------------------------------------------------------
+//--
+//-- Per-channel statistics of 8 bit images, computed from their histograms
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file ChannelStats.h
+ *  \brief Per-channel statistics of 8 bit images, computed from their histograms
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef CHANNELSTATS_H
+#define CHANNELSTATS_H
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+
+/*! \class ChannelStats
+ *  \brief Per-channel statistics of 8 bit images, computed from their histograms
+ *
+ *  Pixels are counted into a 256-bin histogram per channel, in a single pass over the image. Several
+ *  images (e.g. the calibration ROI on consecutive frames) can be accumulated before asking for the
+ *  statistics. Median, median absolute deviation, mean and variance are then computed from the
+ *  histograms in O(256), whatever the number of pixels.
+ */
+class ChannelStats
+{
+    public:
+        //! \brief Number of bins of each histogram
+        static const int BINS = 256;
+
+        //! \brief Creates empty statistics for images with the given number of channels (1 to 4)
+        ChannelStats( int channels = 3 );
+
+        //! \brief Clears the histograms
+        void reset();
+
+        /*! \brief Adds the pixels of an image to the histograms
+         *  \param image 8 bit image with the number of channels given on construction
+         *  \param mask Optional CV_8UC1 mask of the pixels to count
+         */
+        void accumulate( const cv::Mat& image, const cv::Mat& mask = cv::Mat() );
+
+        //! \brief Returns the number of channels
+        int getChannels() const;
+
+        //! \brief Returns the number of pixels accumulated
+        long getCount() const;
+
+        //! \brief Returns the histogram of a channel (BINS counts)
+        const std::vector<long>& getHistogram( int channel ) const;
+
+        //! \brief Returns the largest bin of the histogram of a channel
+        long getMaxBin( int channel ) const;
+
+        //! \brief Returns the median of a channel (the mean of the two central values, rounded up, if the count is even)
+        int median( int channel ) const;
+
+        //! \brief Returns the median absolute deviation of a channel from its median
+        int mad( int channel ) const;
+
+        //! \brief Returns the mean of a channel
+        double mean( int channel ) const;
+
+        //! \brief Returns the variance of a channel
+        double variance( int channel ) const;
+
+        //! \brief Returns the standard deviation of a channel
+        double stdDeviation( int channel ) const;
+
+    private:
+        //! \brief Returns the value with the given rank (0 is the smallest) in a histogram
+        static int valueAt( const std::vector<long>& histogram, long rank );
+
+        //! \brief Returns the median of a histogram with count elements
+        static int median( const std::vector<long>& histogram, long count );
+
+        int channels;                               //!< \brief Number of channels
+        long count;                                 //!< \brief Number of pixels accumulated
+        std::vector< std::vector<long> > histograms;    //!< \brief Histogram of each channel
+};
+
+#endif // CHANNELSTATS_H
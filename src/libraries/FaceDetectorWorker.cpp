@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+//-- FaceDetectorWorker
+//------------------------------------------------------------------------------
+//--
+//-- Runs the face detector on a background thread
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file FaceDetectorWorker.cpp
+ *  \brief Runs the face detector on a background thread
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "FaceDetectorWorker.h"
+#include <iostream>
+
+FaceDetectorWorker::FaceDetectorWorker(const std::string &cascade_file)
+{
+    running = false;
+
+    //-- Load file with the classifier features:
+    if ( ! faceDetector.load( cascade_file ) )
+    {
+        std::cerr << "[Error] Could not load cascade classifier features file." << std::endl;
+        return;
+    }
+
+    //-- Start worker:
+    sem_init( &frame_ready, 0, 0 );
+    running = true;
+
+    if ( pthread_create( &thread, NULL, run, this ) != 0 )
+    {
+        std::cerr << "[Error] Could not start face detection thread." << std::endl;
+        running = false;
+        sem_destroy( &frame_ready );
+    }
+}
+
+FaceDetectorWorker::~FaceDetectorWorker()
+{
+    if ( running )
+    {
+        running = false;
+        sem_post( &frame_ready );
+        pthread_join( thread, NULL );
+        sem_destroy( &frame_ready );
+    }
+}
+
+bool FaceDetectorWorker::isRunning()
+{
+    return running;
+}
+
+void FaceDetectorWorker::submit(const cv::Mat &grey, long frame)
+{
+    if ( !running )
+        return;
+
+    FrameMessage& message = frames.writeSlot();
+    grey.copyTo( message.grey );
+    message.frame = frame;
+    frames.publish();
+
+    sem_post( &frame_ready );
+}
+
+bool FaceDetectorWorker::fetch(std::vector<cv::Rect> &faces, cv::Mat &grey, long &frame)
+{
+    if ( !results.fetch() )
+        return false;
+
+    FacesMessage& message = results.readSlot();
+    faces = message.faces;
+    grey = message.grey;
+    frame = message.frame;
+    return true;
+}
+
+void * FaceDetectorWorker::run(void *worker)
+{
+    ( (FaceDetectorWorker *) worker )->loop();
+    return NULL;
+}
+
+void FaceDetectorWorker::loop()
+{
+    while ( true )
+    {
+        sem_wait( &frame_ready );
+        if ( !running )
+            break;
+
+        //-- Several posts may arrive for a single (newest) frame
+        if ( !frames.fetch() )
+            continue;
+
+        FrameMessage& frame = frames.readSlot();
+        FacesMessage& message = results.writeSlot();
+
+        faceDetector.detectMultiScale( frame.grey, message.faces, 1.1, 2, 0|CV_HAAR_SCALE_IMAGE, cv::Size( 30, 30) );
+        frame.grey.copyTo( message.grey );
+        message.frame = frame.frame;
+
+        results.publish();
+    }
+}
@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+//-- FaceDetectorWorker
+//------------------------------------------------------------------------------
+//--
+//-- Runs the face detector on a background thread
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file FaceDetectorWorker.h
+ *  \brief Runs the face detector on a background thread
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef FACEDETECTORWORKER_H
+#define FACEDETECTORWORKER_H
+
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <semaphore.h>
+#include <opencv2/opencv.hpp>
+#include "Mailbox.h"
+
+
+/*! \class FaceDetectorWorker
+ *  \brief Detects faces on a dedicated thread, so that the caller never waits for the cascade classifier
+ *
+ *  Frames are submitted and results fetched through lock-free mailboxes. The worker always processes the
+ *  newest frame submitted, so frames arriving while it is busy are skipped.
+ */
+class FaceDetectorWorker
+{
+    public:
+        /*! \brief Loads the classifier and starts the worker thread
+         *  \param cascade_file Path of the cascade classifier features file
+         */
+        FaceDetectorWorker( const std::string& cascade_file );
+
+        //! \brief Stops the worker thread
+        ~FaceDetectorWorker();
+
+        //! \brief Returns true if the classifier was loaded and the thread is running
+        bool isRunning();
+
+        /*! \brief Submits a frame for detection (never blocks)
+         *  \param grey Greyscale image where faces are searched for
+         *  \param frame Number of the frame, returned with the results
+         */
+        void submit( const cv::Mat& grey, long frame );
+
+        /*! \brief Takes the newest detection results (never blocks)
+         *  \param faces Faces found
+         *  \param grey Image where the faces were found (valid until the next call)
+         *  \param frame Number of the frame where the faces were found
+         *  \return False if there are no new results since the last call
+         */
+        bool fetch( std::vector<cv::Rect>& faces, cv::Mat& grey, long& frame );
+
+    private:
+        //! \brief Frame sent to the worker
+        struct FrameMessage
+        {
+            cv::Mat grey;
+            long frame;
+        };
+
+        //! \brief Results sent back by the worker
+        struct FacesMessage
+        {
+            std::vector<cv::Rect> faces;
+            cv::Mat grey;
+            long frame;
+        };
+
+        //! \brief Thread entry point
+        static void * run( void * worker );
+
+        //! \brief Detection loop
+        void loop();
+
+        cv::CascadeClassifier faceDetector;     //!< \brief Classifier, only used from the worker thread
+        Mailbox<FrameMessage> frames;           //!< \brief Frames from the caller to the worker
+        Mailbox<FacesMessage> results;          //!< \brief Results from the worker to the caller
+
+        pthread_t thread;                       //!< \brief Worker thread
+        sem_t frame_ready;                      //!< \brief Wakes the worker up when a frame is submitted
+        volatile bool running;                  //!< \brief Cleared to stop the worker
+};
+
+#endif // FACEDETECTORWORKER_H
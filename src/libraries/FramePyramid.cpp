@@ -0,0 +1,290 @@
+//------------------------------------------------------------------------------
+//-- FramePyramid
+//------------------------------------------------------------------------------
+//--
+//-- Scaled and greyscale versions of a frame, shared by all the detector stages
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file FramePyramid.cpp
+ *  \brief Scaled and greyscale versions of a frame, shared by all the detector stages
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "FramePyramid.h"
+
+const unsigned int FramePyramid::GECKO_LEVEL_FULL = 0;
+const unsigned int FramePyramid::GECKO_LEVEL_HALF = 1;
+const unsigned int FramePyramid::GECKO_LEVEL_QUARTER = 2;
+
+const unsigned int FramePyramid::GECKO_FORMAT_BGR = 0;
+const unsigned int FramePyramid::GECKO_FORMAT_YUYV = 1;
+const unsigned int FramePyramid::GECKO_FORMAT_NV12 = 2;
+
+//-- Fixed point grey conversion weights (same as CV_BGR2GRAY), 14 bit
+static const int GREY_B = 1868;
+static const int GREY_G = 9617;
+static const int GREY_R = 4899;
+static const int GREY_SHIFT = 14;
+
+FramePyramid::FramePyramid()
+{
+    format = GECKO_FORMAT_BGR;
+
+    for ( unsigned int i = 0; i < GECKO_NUM_LEVELS; i++ )
+        builtBGR[i] = builtGrey[i] = false;
+}
+
+void FramePyramid::setFrame(const cv::Mat &frame, unsigned int format)
+{
+    this->format = format;
+
+    for ( unsigned int i = 0; i < GECKO_NUM_LEVELS; i++ )
+        builtBGR[i] = builtGrey[i] = false;
+
+    if ( format == GECKO_FORMAT_BGR )
+    {
+        levelsBGR[GECKO_LEVEL_FULL] = frame;
+        builtBGR[GECKO_LEVEL_FULL] = true;
+        frameYUV.release();
+        return;
+    }
+
+    frameYUV = frame;
+
+    //-- The Y plane is the full resolution grey image:
+    if ( format == GECKO_FORMAT_NV12 )
+    {
+        CV_Assert( frame.type() == CV_8UC1 && frame.rows % 3 == 0 );
+        levelsGrey[GECKO_LEVEL_FULL] = frame.rowRange( 0, frame.rows * 2 / 3 );
+    }
+    else
+    {
+        CV_Assert( format == GECKO_FORMAT_YUYV && frame.type() == CV_8UC2 );
+        levelsGrey[GECKO_LEVEL_FULL].create( frame.size(), CV_8UC1 );
+
+        for ( int i = 0; i < frame.rows; i++ )
+        {
+            const uchar * yuyv = frame.ptr<uchar>( i );
+            uchar * grey = levelsGrey[GECKO_LEVEL_FULL].ptr<uchar>( i );
+
+            for ( int j = 0; j < frame.cols; j++ )
+                grey[j] = yuyv[ 2 * j ];
+        }
+    }
+
+    builtGrey[GECKO_LEVEL_FULL] = true;
+}
+
+unsigned int FramePyramid::getFormat()
+{
+    return format;
+}
+
+cv::Size FramePyramid::size()
+{
+    if ( format == GECKO_FORMAT_NV12 )
+        return cv::Size( frameYUV.cols, frameYUV.rows * 2 / 3 );
+    else if ( format == GECKO_FORMAT_YUYV )
+        return frameYUV.size();
+
+    return levelsBGR[GECKO_LEVEL_FULL].size();
+}
+
+const cv::Mat& FramePyramid::bgr(unsigned int level)
+{
+    buildLevel( level );
+    return levelsBGR[level];
+}
+
+cv::Mat FramePyramid::bgr(const cv::Rect &roi)
+{
+    if ( builtBGR[GECKO_LEVEL_FULL] )
+        return levelsBGR[GECKO_LEVEL_FULL]( roi );
+
+    convertYUV( frameYUV, format, roi, roiBGR );
+    return roiBGR;
+}
+
+const cv::Mat& FramePyramid::grey(unsigned int level)
+{
+    if ( format != GECKO_FORMAT_BGR )
+    {
+        buildGreyLevel( level );
+        return levelsGrey[level];
+    }
+
+    if ( level == GECKO_LEVEL_FULL && !builtGrey[level] )
+    {
+        //-- The full resolution grey image is the only one not built along with its BGR level
+        cv::cvtColor( levelsBGR[level], levelsGrey[level], CV_BGR2GRAY );
+        builtGrey[level] = true;
+    }
+
+    buildLevel( level );
+    return levelsGrey[level];
+}
+
+double FramePyramid::scale(unsigned int level)
+{
+    return 1.0 / ( 1 << level );
+}
+
+void FramePyramid::buildLevel(unsigned int level)
+{
+    //-- Only for YUV frames, and only if asked for:
+    if ( level == GECKO_LEVEL_FULL && !builtBGR[level] )
+    {
+        cv::cvtColor( frameYUV, levelsBGR[level], format == GECKO_FORMAT_NV12 ? CV_YUV2BGR_NV12 : CV_YUV2BGR_YUYV );
+        builtBGR[level] = true;
+    }
+
+    for ( unsigned int i = 1; i <= level; i++ )
+        if ( !builtBGR[i] )
+        {
+            if ( format == GECKO_FORMAT_BGR )
+            {
+                halve( levelsBGR[i-1], levelsBGR[i], &levelsGrey[i] );
+                builtGrey[i] = true;
+            }
+            else if ( i == GECKO_LEVEL_HALF )
+                halveYUV( frameYUV, format, size(), levelsBGR[i] );
+            else
+                halve( levelsBGR[i-1], levelsBGR[i], NULL );
+
+            builtBGR[i] = true;
+        }
+}
+
+void FramePyramid::buildGreyLevel(unsigned int level)
+{
+    for ( unsigned int i = 1; i <= level; i++ )
+        if ( !builtGrey[i] )
+        {
+            halveGrey( levelsGrey[i-1], levelsGrey[i] );
+            builtGrey[i] = true;
+        }
+}
+
+void FramePyramid::halve(const cv::Mat &src, cv::Mat &dstBGR, cv::Mat * dstGrey)
+{
+    CV_Assert( src.type() == CV_8UC3 );
+
+    dstBGR.create( src.rows / 2, src.cols / 2, CV_8UC3 );
+    if ( dstGrey )
+        dstGrey->create( src.rows / 2, src.cols / 2, CV_8UC1 );
+
+    for ( int i = 0; i < dstBGR.rows; i++ )
+    {
+        const uchar * top = src.ptr<uchar>( 2 * i );
+        const uchar * bottom = src.ptr<uchar>( 2 * i + 1 );
+        uchar * bgr = dstBGR.ptr<uchar>( i );
+        uchar * grey = dstGrey ? dstGrey->ptr<uchar>( i ) : NULL;
+
+        for ( int j = 0; j < dstBGR.cols; j++, top += 6, bottom += 6, bgr += 3 )
+        {
+            //-- Rounded average of the 2x2 block:
+            int b = ( top[0] + top[3] + bottom[0] + bottom[3] + 2 ) >> 2;
+            int g = ( top[1] + top[4] + bottom[1] + bottom[4] + 2 ) >> 2;
+            int r = ( top[2] + top[5] + bottom[2] + bottom[5] + 2 ) >> 2;
+
+            bgr[0] = b;
+            bgr[1] = g;
+            bgr[2] = r;
+
+            if ( grey )
+                grey[j] = ( b * GREY_B + g * GREY_G + r * GREY_R + ( 1 << ( GREY_SHIFT - 1 ) ) ) >> GREY_SHIFT;
+        }
+    }
+}
+
+void FramePyramid::halveGrey(const cv::Mat &src, cv::Mat &dst)
+{
+    CV_Assert( src.type() == CV_8UC1 );
+    dst.create( src.rows / 2, src.cols / 2, CV_8UC1 );
+
+    for ( int i = 0; i < dst.rows; i++ )
+    {
+        const uchar * top = src.ptr<uchar>( 2 * i );
+        const uchar * bottom = src.ptr<uchar>( 2 * i + 1 );
+        uchar * d = dst.ptr<uchar>( i );
+
+        for ( int j = 0; j < dst.cols; j++ )
+            d[j] = ( top[2*j] + top[2*j+1] + bottom[2*j] + bottom[2*j+1] + 2 ) >> 2;
+    }
+}
+
+void FramePyramid::halveYUV(const cv::Mat &src, unsigned int format, const cv::Size &size, cv::Mat &dst)
+{
+    dst.create( size.height / 2, size.width / 2, CV_8UC3 );
+
+    for ( int i = 0; i < dst.rows; i++ )
+    {
+        uchar * bgr = dst.ptr<uchar>( i );
+
+        if ( format == GECKO_FORMAT_YUYV )
+        {
+            //-- Each 4 bytes (Y0 U Y1 V) are a 2x1 block, with its own chroma:
+            const uchar * top = src.ptr<uchar>( 2 * i );
+            const uchar * bottom = src.ptr<uchar>( 2 * i + 1 );
+
+            for ( int j = 0; j < dst.cols; j++, top += 4, bottom += 4, bgr += 3 )
+                yuvToBGR( ( top[0] + top[2] + bottom[0] + bottom[2] + 2 ) >> 2,
+                          ( top[1] + bottom[1] + 1 ) >> 1,
+                          ( top[3] + bottom[3] + 1 ) >> 1, bgr );
+        }
+        else
+        {
+            //-- The chroma plane is already at half resolution:
+            const uchar * top = src.ptr<uchar>( 2 * i );
+            const uchar * bottom = src.ptr<uchar>( 2 * i + 1 );
+            const uchar * uv = src.ptr<uchar>( size.height + i );
+
+            for ( int j = 0; j < dst.cols; j++, top += 2, bottom += 2, uv += 2, bgr += 3 )
+                yuvToBGR( ( top[0] + top[1] + bottom[0] + bottom[1] + 2 ) >> 2, uv[0], uv[1], bgr );
+        }
+    }
+}
+
+void FramePyramid::convertYUV(const cv::Mat &src, unsigned int format, const cv::Rect &roi, cv::Mat &dst)
+{
+    dst.create( roi.size(), CV_8UC3 );
+
+    int height = format == GECKO_FORMAT_NV12 ? src.rows * 2 / 3 : src.rows;
+
+    for ( int i = 0; i < roi.height; i++ )
+    {
+        int row = roi.y + i;
+        const uchar * y = src.ptr<uchar>( row );
+        uchar * bgr = dst.ptr<uchar>( i );
+
+        if ( format == GECKO_FORMAT_YUYV )
+        {
+            //-- The chroma of each pixel is in the 4 bytes (Y0 U Y1 V) of its pair:
+            for ( int col = roi.x; col < roi.x + roi.width; col++, bgr += 3 )
+            {
+                const uchar * pair = y + 4 * ( col / 2 );
+                yuvToBGR( y[ 2 * col ], pair[1], pair[3], bgr );
+            }
+        }
+        else
+        {
+            const uchar * uv = src.ptr<uchar>( height + row / 2 );
+
+            for ( int col = roi.x; col < roi.x + roi.width; col++, bgr += 3 )
+                yuvToBGR( y[col], uv[ col & ~1 ], uv[ col | 1 ], bgr );
+        }
+    }
+}
@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+//-- FramePyramid
+//------------------------------------------------------------------------------
+//--
+//-- Scaled and greyscale versions of a frame, shared by all the detector stages
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file FramePyramid.h
+ *  \brief Scaled and greyscale versions of a frame, shared by all the detector stages
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef FRAMEPYRAMID_H
+#define FRAMEPYRAMID_H
+
+#include <opencv2/opencv.hpp>
+
+
+/*! \class FramePyramid
+ *  \brief Full, 1/2 and 1/4 scale versions of a frame, in BGR and greyscale
+ *
+ *  Levels are computed the first time they are requested after setFrame(), and then reused by any
+ *  other stage that needs them. Each reduced level is built from the previous one in a single pass
+ *  that averages 2x2 blocks and converts them to grey at the same time. The buffers are kept between
+ *  frames, so nothing is allocated while the frame size does not change.
+ *
+ *  Frames can also be given in the YUYV or NV12 formats of the cameras. The greyscale levels are then
+ *  the Y plane and its reductions, the half resolution BGR level is converted straight from the
+ *  subsampled YUV, and the full resolution BGR image is only converted if a stage asks for it.
+ */
+class FramePyramid
+{
+    public:
+        //-- Pyramid levels
+        //-----------------------------------------------------------------------
+        //! \brief Full resolution
+        static const unsigned int GECKO_LEVEL_FULL;
+        //! \brief Half resolution
+        static const unsigned int GECKO_LEVEL_HALF;
+        //! \brief Quarter resolution
+        static const unsigned int GECKO_LEVEL_QUARTER;
+        //! \brief Number of levels
+        static const unsigned int GECKO_NUM_LEVELS = 3;
+
+        //-- Frame formats
+        //-----------------------------------------------------------------------
+        //! \brief Packed BGR (CV_8UC3)
+        static const unsigned int GECKO_FORMAT_BGR;
+        //! \brief Packed YUV 4:2:2, Y0 U Y1 V (CV_8UC2, one element per pixel)
+        static const unsigned int GECKO_FORMAT_YUYV;
+        //! \brief Planar YUV 4:2:0, Y plane followed by an interleaved UV plane (CV_8UC1, 3/2 of the frame rows)
+        static const unsigned int GECKO_FORMAT_NV12;
+
+        //! \brief Default constructor
+        FramePyramid();
+
+        /*! \brief Sets the frame for the next computations, discarding the previous levels
+         *  \param frame Image in the given format. It is not copied, so it must not change while in use
+         *  \param format One of the GECKO_FORMAT_* constants
+         */
+        void setFrame( const cv::Mat& frame, unsigned int format = GECKO_FORMAT_BGR );
+
+        //! \brief Returns the format of the current frame
+        unsigned int getFormat();
+
+        //! \brief Returns the size of the current frame, in pixels
+        cv::Size size();
+
+        //! \brief Returns the BGR image at the given level
+        const cv::Mat& bgr( unsigned int level );
+
+        /*! \brief Returns the BGR pixels of a region of the full resolution frame
+         *
+         *  If the frame is in a YUV format and the full BGR image has not been built, only the region
+         *  is converted (to a buffer that is reused by the next call).
+         */
+        cv::Mat bgr( const cv::Rect& roi );
+
+        //! \brief Returns the greyscale image at the given level
+        const cv::Mat& grey( unsigned int level );
+
+        //! \brief Returns the size of a level relative to the full frame (1, 0.5 or 0.25)
+        static double scale( unsigned int level );
+
+        //! \brief Converts a YUV pixel to BGR, with the ITU-R BT.601 integer coefficients of cv::cvtColor
+        static inline void yuvToBGR( int y, int u, int v, uchar * bgr )
+        {
+            const int shift = 20;
+            const int half = 1 << ( shift - 1 );
+
+            int luma = std::max( 0, y - 16 ) * 1220542;
+            u -= 128;
+            v -= 128;
+
+            bgr[0] = cv::saturate_cast<uchar>( ( luma + half + 2116026 * u ) >> shift );
+            bgr[1] = cv::saturate_cast<uchar>( ( luma + half - 409993 * u - 852492 * v ) >> shift );
+            bgr[2] = cv::saturate_cast<uchar>( ( luma + half + 1673527 * v ) >> shift );
+        }
+
+    private:
+        //! \brief Builds a level (and the ones above it) if not already done for this frame
+        void buildLevel( unsigned int level );
+
+        //! \brief Builds a greyscale level from the Y plane, for YUV frames
+        void buildGreyLevel( unsigned int level );
+
+        /*! \brief Halves an image averaging 2x2 blocks, and converts the result to grey in the same pass
+         *  \param src BGR input image
+         *  \param dstBGR BGR image with half the size of src
+         *  \param dstGrey Greyscale version of dstBGR (NULL to skip it)
+         */
+        static void halve( const cv::Mat& src, cv::Mat& dstBGR, cv::Mat * dstGrey );
+
+        //! \brief Halves a greyscale image averaging 2x2 blocks
+        static void halveGrey( const cv::Mat& src, cv::Mat& dst );
+
+        /*! \brief Halves a YUV frame averaging the Y of 2x2 blocks, and converts the result to BGR in the same pass
+         *  \param src YUYV or NV12 frame
+         *  \param format Format of src
+         *  \param size Size of the frame in pixels
+         *  \param dst BGR image with half the size of the frame
+         */
+        static void halveYUV( const cv::Mat& src, unsigned int format, const cv::Size& size, cv::Mat& dst );
+
+        /*! \brief Converts a region of a YUV frame to BGR
+         *  \param src YUYV or NV12 frame
+         *  \param format Format of src
+         *  \param roi Region, in pixels of the frame
+         *  \param dst BGR image with the size of the region
+         */
+        static void convertYUV( const cv::Mat& src, unsigned int format, const cv::Rect& roi, cv::Mat& dst );
+
+        unsigned int format;                    //!< \brief Format of the current frame
+        cv::Mat frameYUV;                       //!< \brief Current frame, if in a YUV format
+        cv::Mat roiBGR;                         //!< \brief Buffer for the regions converted from YUV
+
+        cv::Mat levelsBGR[GECKO_NUM_LEVELS];    //!< \brief BGR images, from full to quarter resolution
+        cv::Mat levelsGrey[GECKO_NUM_LEVELS];   //!< \brief Greyscale images, from full to quarter resolution
+        bool builtBGR[GECKO_NUM_LEVELS];        //!< \brief Whether each BGR level is up to date
+        bool builtGrey[GECKO_NUM_LEVELS];       //!< \brief Whether each greyscale level is up to date
+};
+
+#endif // FRAMEPYRAMID_H
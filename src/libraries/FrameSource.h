@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+//-- FrameSource
+//------------------------------------------------------------------------------
+//--
+//-- Interface of the sources of frames for the detector
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file FrameSource.h
+ *  \brief Interface of the sources of frames for the detector
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <opencv2/opencv.hpp>
+#include "FramePyramid.h"
+
+
+/*! \class FrameSource
+ *  \brief Interface of the sources of frames for the detector
+ *
+ *  Unlike cv::VideoCapture, which always delivers BGR, a source can give the frames in the native
+ *  format of the device or file (see the FramePyramid::GECKO_FORMAT_* constants), so that they can be
+ *  processed without a conversion.
+ */
+class FrameSource
+{
+    public:
+        virtual ~FrameSource() {}
+
+        //! \brief Returns true if the source could be opened
+        virtual bool isOpened() = 0;
+
+        /*! \brief Reads the next frame
+         *  \param frame Output frame, in the format given by getFormat(). It may share its buffer with
+         *  the source, so it is only valid until the next call
+         *  \return False if there are no more frames
+         */
+        virtual bool read( cv::Mat& frame ) = 0;
+
+        //! \brief Returns the format of the last frame read (one of the FramePyramid::GECKO_FORMAT_* constants)
+        virtual unsigned int getFormat() = 0;
+};
+
+#endif // FRAMESOURCE_H
@@ -44,6 +44,8 @@ HandDescriptor::HandDescriptor()
     _hand_gesture = GECKO_GESTURE_NONE;
     _hand_num_fingers = -1;
     _hand_found = false;
+    _mirrored = false;
+    _frame_width = 0;
 
 
     //-- Kalman filter setup for estimating hand angle:
@@ -96,15 +98,17 @@ HandDescriptor::HandDescriptor()
 //-----------------------------------------------------------------------------------------------------------------------
 //-- Refresh the detected hand characteristics
 //-----------------------------------------------------------------------------------------------------------------------
-void HandDescriptor::operator ()(const cv::Mat& skinMask )
+void HandDescriptor::operator ()(const cv::Mat& skinMask, const cv::Rect& handBox )
 {
-    update ( skinMask );
+    update ( skinMask, handBox );
 }
 
-void HandDescriptor::update( const cv::Mat& skinMask )
+void HandDescriptor::update( const cv::Mat& skinMask, const cv::Rect& handBox )
 {
+    _frame_width = skinMask.cols;
+
     //-- Do things to update each parameter
-    contourExtraction( skinMask );
+    contourExtraction( skinMask, handBox );
 
     //-- Check if some hand was found:
     if ( _hand_found )
@@ -118,10 +122,16 @@ void HandDescriptor::update( const cv::Mat& skinMask )
 	//-- Second roi and contourExtraction
         ROIExtraction( skinMask );
 
-        cv::Mat remaskedHand;
-        cv::bitwise_and( skinMask, _hand_ROI, remaskedHand );
-        contourExtraction( remaskedHand );
+        //-- Masking with the ROI is just cropping the hand box to it:
+        cv::Rect remaskedBox = _hand_bounding_box & _hand_ROI;
+        if ( remaskedBox.area() > 0 )
+            contourExtraction( skinMask, remaskedBox );
+        else
+            _hand_found = false;
+    }
 
+    if ( _hand_found )
+    {
         //-- Find the min enclosing circle of the latest contour:
         cv::minEnclosingCircle( _hand_contour[0], _min_enclosing_circle_center, _min_enclosing_circle_radius );
 
@@ -192,6 +202,46 @@ void HandDescriptor::gestureExtraction()
 }
 
 
+//-----------------------------------------------------------------------------------------------------------------------
+//-- Mirrored output
+//-----------------------------------------------------------------------------------------------------------------------
+
+void HandDescriptor::setMirrored(bool mirrored)
+{
+    _mirrored = mirrored;
+}
+
+bool HandDescriptor::getMirrored()
+{
+    return _mirrored;
+}
+
+cv::Point HandDescriptor::mirror(const cv::Point &point)
+{
+    return _mirrored ? cv::Point( _frame_width - 1 - point.x, point.y ) : point;
+}
+
+cv::Point2f HandDescriptor::mirror(const cv::Point2f &point)
+{
+    return _mirrored ? cv::Point2f( _frame_width - 1 - point.x, point.y ) : point;
+}
+
+std::vector<cv::Point> HandDescriptor::mirror(const std::vector<cv::Point> &points)
+{
+    std::vector<cv::Point> mirrored( points.size() );
+    for ( int i = 0; i < (int) points.size(); i++ )
+        mirrored[i] = mirror( points[i] );
+
+    return mirrored;
+}
+
+double HandDescriptor::mirrorAngle(double angle)
+{
+    //-- Angles are measured from the X axis, counterclockwise
+    return _mirrored ? 180 - angle : angle;
+}
+
+
 //-----------------------------------------------------------------------------------------------------------------------
 //-- Get the characteristics of the hand
 //-----------------------------------------------------------------------------------------------------------------------
@@ -203,32 +253,32 @@ bool HandDescriptor::handFound()
 
 double HandDescriptor::getHandAngle ()
 {
-    return _hand_angle;
+    return mirrorAngle( _hand_angle );
 }
 
 double HandDescriptor::getHandAnglePredicted()
 {
-    return _hand_angle_prediction;
+    return mirrorAngle( _hand_angle_prediction );
 }
 
 double HandDescriptor::getHandAngleEstimated()
 {
-    return _hand_angle_estimation;
+    return mirrorAngle( _hand_angle_estimation );
 }
 
 cv::Point HandDescriptor::getCenterHand ()
 {
-    return _hand_center;
+    return mirror( _hand_center );
 }
 
 cv::Point HandDescriptor::getCenterHandPredicted()
 {
-    return _hand_center_prediction;
+    return mirror( _hand_center_prediction );
 }
 
 cv::Point HandDescriptor::getCenterHandEstimated()
 {
-    return _hand_center_estimation;
+    return mirror( _hand_center_estimation );
 }
 
 std::vector< std::vector<cv::Point> > HandDescriptor::getContours()
@@ -241,6 +291,27 @@ cv::Rect HandDescriptor::getBoundingBox()
     return _hand_bounding_box;
 }
 
+cv::Rect HandDescriptor::getSearchWindow(const cv::Size &frame_size, float margin)
+{
+    if ( !_hand_found )
+        return cv::Rect();
+
+    //-- Displacement expected for the next frame:
+    int vx = kalmanFilterCenter.statePost.at<float>(2);
+    int vy = kalmanFilterCenter.statePost.at<float>(3);
+
+    //-- Move and enlarge the bounding box:
+    int margin_x = _hand_bounding_box.width * margin + abs( vx );
+    int margin_y = _hand_bounding_box.height * margin + abs( vy );
+
+    cv::Rect window( _hand_bounding_box.x + vx - margin_x,
+                     _hand_bounding_box.y + vy - margin_y,
+                     _hand_bounding_box.width + 2 * margin_x,
+                     _hand_bounding_box.height + 2 * margin_y );
+
+    return window & cv::Rect( 0, 0, frame_size.width, frame_size.height );
+}
+
 int HandDescriptor::getGesture()
 {
     return _hand_gesture;
@@ -272,11 +343,11 @@ void HandDescriptor::plotBoundingRectangle(const cv::Mat& src, cv::Mat& dst, boo
             //-- Draw rotated rectangle:
             cv::Point2f rect_points[4]; _hand_rotated_bounding_box.points( rect_points );
             for( int j = 0; j < 4; j++ )
-            cv::line( dst, rect_points[j], rect_points[(j+1)%4], cv::Scalar(255, 0, 0) , 2 );
+            cv::line( dst, mirror( rect_points[j] ), mirror( rect_points[(j+1)%4] ), cv::Scalar(255, 0, 0) , 2 );
         }
         else
         {
-            cv::rectangle( dst, _hand_bounding_box, cv::Scalar( 255, 0, 0), 2 );
+            cv::rectangle( dst, mirror( _hand_bounding_box.tl() ), mirror( _hand_bounding_box.br() - cv::Point( 1, 1 ) ), cv::Scalar( 255, 0, 0), 2 );
         }
     }
 }
@@ -292,7 +363,8 @@ void HandDescriptor::plotContours(const cv::Mat& src, cv::Mat& dst)
     if ( _hand_found )
     {
 	//-- Draw contours:
-	cv::drawContours( dst, _hand_contour, 0, cv::Scalar( 0, 0, 255), 1, 8);
+	std::vector< std::vector<cv::Point> > contours( 1, mirror( _hand_contour[0] ) );
+	cv::drawContours( dst, contours, 0, cv::Scalar( 0, 0, 255), 1, 8);
 	//cv::fillConvexPoly( dst, contours[largestId], cv::Scalar( 255, 255, 255));
     }
     else
@@ -311,15 +383,15 @@ void HandDescriptor::plotCenter(const cv::Mat& src, cv::Mat& dst, bool show_corr
     {
         if ( show_predicted )
             //-- Print predicted point on screen:
-            cv::circle( dst, _hand_center_prediction, 4, cv::Scalar( 0, 255, 0), 2 );
+            cv::circle( dst, mirror( _hand_center_prediction ), 4, cv::Scalar( 0, 255, 0), 2 );
 
         if ( show_actual )
             //-- Print cog on screen:
-            cv::circle( dst, _hand_center, 5, cv::Scalar( 255, 0, 0), 2 );
+            cv::circle( dst, mirror( _hand_center ), 5, cv::Scalar( 255, 0, 0), 2 );
 
         if ( show_corrected )
             //-- Print estimation on screen:
-            cv::circle( dst, _hand_center_estimation, 3, cv::Scalar( 0, 0, 255), 2 );
+            cv::circle( dst, mirror( _hand_center_estimation ), 3, cv::Scalar( 0, 0, 255), 2 );
     }
 
 }
@@ -331,10 +403,10 @@ void HandDescriptor::plotMaxInscribedCircle(cv::Mat& src, cv::Mat& dst, bool sho
 
     if ( _hand_found )
     {
-        cv::circle( dst, _max_circle_incribed_center, _max_circle_inscribed_radius, color, thickness);
+        cv::circle( dst, mirror( _max_circle_incribed_center ), _max_circle_inscribed_radius, color, thickness);
 
         if (show_center)
-            cv::circle( dst, _max_circle_incribed_center, 2, color,  thickness);
+            cv::circle( dst, mirror( _max_circle_incribed_center ), 2, color,  thickness);
     }
 }
 
@@ -346,10 +418,10 @@ void HandDescriptor::plotMinEnclosingCircle( cv::Mat& src, cv::Mat& dst, bool sh
 
     if ( _hand_found)
     {
-        cv::circle( dst, _min_enclosing_circle_center, _min_enclosing_circle_radius, color , thickness);
+        cv::circle( dst, mirror( _min_enclosing_circle_center ), _min_enclosing_circle_radius, color , thickness);
 
         if (show_center)
-            cv::circle( dst, _min_enclosing_circle_center, 2, color, thickness);
+            cv::circle( dst, mirror( _min_enclosing_circle_center ), 2, color, thickness);
     }
 }
 
@@ -361,7 +433,7 @@ void HandDescriptor::plotComplexHull( cv::Mat& src, cv::Mat& dst, bool show_poin
     if ( _hand_found )
     {
         std::vector< std::vector < cv::Point > > points_to_show;
-        points_to_show.push_back( _hand_hull);
+        points_to_show.push_back( mirror( _hand_hull ) );
 
         cv::drawContours( dst, points_to_show, 0, color, thickness);
 
@@ -387,13 +459,13 @@ void HandDescriptor::plotConvexityDefects(cv::Mat &src, cv::Mat &dst, bool draw_
            //-- Draw them
            if ( draw_points )
            {
-                cv::circle( dst, _hand_convexity_defects[i].start, 5, orange);
-                cv::circle( dst, _hand_convexity_defects[i].end, 5, orange);
-                cv::circle( dst, _hand_convexity_defects[i].depth_point, 5, orange);
+                cv::circle( dst, mirror( _hand_convexity_defects[i].start ), 5, orange);
+                cv::circle( dst, mirror( _hand_convexity_defects[i].end ), 5, orange);
+                cv::circle( dst, mirror( _hand_convexity_defects[i].depth_point ), 5, orange);
            }
 
-           cv::line(dst, _hand_convexity_defects[i].start, _hand_convexity_defects[i].depth_point, orange);
-           cv::line(dst, _hand_convexity_defects[i].depth_point, _hand_convexity_defects[i].end, orange);
+           cv::line(dst, mirror( _hand_convexity_defects[i].start ), mirror( _hand_convexity_defects[i].depth_point ), orange);
+           cv::line(dst, mirror( _hand_convexity_defects[i].depth_point ), mirror( _hand_convexity_defects[i].end ), orange);
         }
 
     }
@@ -407,10 +479,10 @@ void HandDescriptor::plotFingertips(cv::Mat &src, cv::Mat &dst, bool draw_lines,
     if ( _hand_found )
         for( int i = 0; i < _hand_fingertips.size(); i++)
         {
-            cv::circle( dst, _hand_fingertips[i], 10, color, thickness );
+            cv::circle( dst, mirror( _hand_fingertips[i] ), 10, color, thickness );
 
             if ( draw_lines )
-                cv::line( dst, _hand_finger_line_origin[i], _hand_fingertips[i], color, thickness);
+                cv::line( dst, mirror( _hand_finger_line_origin[i] ), mirror( _hand_fingertips[i] ), color, thickness);
         }
 
 }
@@ -447,7 +519,7 @@ void HandDescriptor::angleControl(bool show_corrected, bool show_actual, bool sh
     //-- Calculate and print actual end:
     if ( show_actual )
     {
-	double rad_ang = _hand_angle * 3.1415 / 180.0;
+	double rad_ang = mirrorAngle( _hand_angle ) * 3.1415 / 180.0;
 	int x_coord = gauge_l * cos( rad_ang);
 	int y_coord = gauge_l * sin( rad_ang);
 	cv::Point gaugeEnd( 200/2 + x_coord , 80 - y_coord);
@@ -457,7 +529,7 @@ void HandDescriptor::angleControl(bool show_corrected, bool show_actual, bool sh
     //-- Calculate and print predicted end:
     if ( show_predicted)
     {
-	double rad_ang_predicted = _hand_angle_prediction * 3.1415 / 180.0;
+	double rad_ang_predicted = mirrorAngle( _hand_angle_prediction ) * 3.1415 / 180.0;
 	int x_coord_predicted = gauge_l * cos( rad_ang_predicted);
 	int y_coord_predicted = gauge_l * sin( rad_ang_predicted);
 	cv::Point predictedGaugeEnd( 200/2 + x_coord_predicted , 80 - y_coord_predicted);
@@ -467,7 +539,7 @@ void HandDescriptor::angleControl(bool show_corrected, bool show_actual, bool sh
     //-- Calculate and print estimated end:
     if ( show_corrected )
     {
-	double rad_ang_estimated = _hand_angle_estimation * 3.1415 / 180.0;
+	double rad_ang_estimated = mirrorAngle( _hand_angle_estimation ) * 3.1415 / 180.0;
 	int x_coord_estimated = gauge_l * cos( rad_ang_estimated);
 	int y_coord_estimated = gauge_l * sin( rad_ang_estimated);
 	cv::Point estimatedGaugeEnd( 200/2 + x_coord_estimated , 80 - y_coord_estimated);
@@ -483,27 +555,50 @@ void HandDescriptor::angleControl(bool show_corrected, bool show_actual, bool sh
 //-- Functions that extract characteristics:
 //-----------------------------------------------------------------------------------------------------------------------
 
-void HandDescriptor::contourExtraction(const cv::Mat& skinMask)
+void HandDescriptor::contourExtraction(const cv::Mat& skinMask, const cv::Rect& handBox)
 {
     const int epsilon = 1; //-- Max error for polygon approximation
+    const int min_hand_area = 1000; //-- Min. number of pixels of a hand blob
 
-    //-- Extract skin contours:
-    std::vector<std::vector<cv::Point> > raw_contours;
-    cv::findContours(skinMask, raw_contours, CV_RETR_LIST, CV_CHAIN_APPROX_SIMPLE, cv::Point(0,0) );
+    //-- Find the hand blob:
+    cv::Rect box = handBox & cv::Rect( 0, 0, skinMask.cols, skinMask.rows );
 
-    //-- Filter the contours by size:
-    std::vector<std::vector<cv::Point> > filtered_hand_contours;
-    filterContours( raw_contours, filtered_hand_contours);
+    if ( box.area() == 0 )
+    {
+        labelBlobs( skinMask, _blob_labels, _blobs, _blob_buffers );
+
+        int hand_blob = largestBlob( _blobs, min_hand_area );
+        if ( hand_blob >= 0 )
+            box = _blobs[hand_blob].boundingBox;
+    }
+
+    _hand_found = box.area() > 0;
+    _hand_contour.clear();
+
+    if ( !_hand_found )
+        return;
+
+    //-- Extract the contours inside the blob box (findContours ignores the image border, so add one):
+    cv::Mat blobMask;
+    cv::copyMakeBorder( skinMask( box ), blobMask, 1, 1, 1, 1, cv::BORDER_CONSTANT, cv::Scalar( 0 ) );
+
+    std::vector<std::vector<cv::Point> > raw_contours;
+    cv::findContours( blobMask, raw_contours, CV_RETR_EXTERNAL, CV_CHAIN_APPROX_SIMPLE, box.tl() - cv::Point( 1, 1 ) );
 
-    //-- Set a flag in case no hands have been found:
-    _hand_found = (int) filtered_hand_contours.size() > 0 ;
+    //-- The blob is the largest contour in its own box:
+    int largest = -1;
+    for ( int i = 0; i < raw_contours.size(); i++ )
+        if ( largest < 0 || raw_contours[i].size() > raw_contours[largest].size() )
+            largest = i;
 
-    //-- If contour was found, make a aproximation of them:
-    _hand_contour = std::vector<std::vector<cv::Point > >( filtered_hand_contours.size() );
+    _hand_found = largest >= 0;
 
+    //-- If contour was found, make a aproximation of it:
     if ( _hand_found )
-        for( int i = 0; i < filtered_hand_contours.size(); i++)
-            cv::approxPolyDP( filtered_hand_contours[i], _hand_contour[i], epsilon, True );
+    {
+        _hand_contour = std::vector<std::vector<cv::Point > >( 1 );
+        cv::approxPolyDP( raw_contours[largest], _hand_contour[0], epsilon, True );
+    }
 }
 
 void HandDescriptor::boundingBoxExtraction()
@@ -522,60 +617,37 @@ void HandDescriptor::handPalmExtraction()
     const int x_ratio = 3; //-- Section of the bounding box used for finding center (along X)
     const int y_ratio = 3; //-- Section of the bounding box used for finding center (along Y)
 
-    const int step_contour = 1; //-- Test each 'step' points of the contour for easier calculations
-    const int step_points_inside = 1;//-- Test each 'step' points inside the contour
-
+    //-- Fill the contour into a mask of its bounding box, with a one pixel border of background so that
+    //-- the hand never touches the edge of the mask:
+    cv::Rect box = _hand_bounding_box;
+    _palm_mask.create( box.height + 2, box.width + 2, CV_8UC1 );
+    _palm_mask.setTo( cv::Scalar( 0 ) );
+    cv::fillPoly( _palm_mask, _hand_contour, cv::Scalar( 255 ), 8, 0, cv::Point( 1, 1 ) - box.tl() );
 
-    //-- Extract points to use
-    std::vector< cv::Point > points_to_use;
-
-    if ( step_contour == 1)
-    {
-        points_to_use = _hand_contour[0];
-    }
-    else
-    {
-        for (int i = 0; i < (int) ( _hand_contour[0].size() / (float) step_contour); i++)
-            points_to_use.push_back( _hand_contour[0][i]);
-    }
+    //-- Exact euclidean distance from each pixel to the background, in linear time:
+    cv::distanceTransform( _palm_mask, _palm_distance, CV_DIST_L2, CV_DIST_MASK_PRECISE );
 
-    //-- Find initial and ending points of the area to look for
+    //-- Find initial and ending points of the area to look for (in mask coordinates)
     std::pair<int,int> x_limits, y_limits;
 
-    x_limits.first = _hand_bounding_box.x + _hand_bounding_box.width /  x_ratio;
-    x_limits.second = _hand_bounding_box.x + (int) ( _hand_bounding_box.width * (1 - 1 /(float) x_ratio));
+    x_limits.first = 1 + box.width /  x_ratio;
+    x_limits.second = 1 + (int) ( box.width * (1 - 1 /(float) x_ratio));
 
-    y_limits.first = _hand_bounding_box.y + _hand_bounding_box.height / y_ratio;
-    y_limits.second = _hand_bounding_box.y + (int) ( _hand_bounding_box.height * (1 - 1 /(float) y_ratio));
+    y_limits.first = 1 + box.height / y_ratio;
+    y_limits.second = 1 + (int) ( box.height * (1 - 1 /(float) y_ratio));
 
+    cv::Rect search_area( x_limits.first, y_limits.first, x_limits.second - x_limits.first, y_limits.second - y_limits.first );
 
-    //-- Look for center and radius
-    std::pair<int, int> best_center = std::pair<int, int>( x_limits.first, y_limits.first);
-    double best_distance = -1;
-
-    /*
-    std::cout << "(" << x_limits.first << ", " << x_limits.second << ")" << std::endl;
-    std::cout << "(" << y_limits.first << ", " << y_limits.second << ")" << std::endl;
-    */
 
-    for (int j = y_limits.first; j < y_limits.second; j += step_points_inside )
-        for (int i = x_limits.first; i < x_limits.second; i += step_points_inside )
-        {
-            double current_distance = cv::pointPolygonTest( points_to_use, cv::Point(i, j), true );
-
-            if (current_distance > 0 && current_distance > best_distance)
-            {
-                best_distance = current_distance;
-                best_center.first = i;
-                best_center.second = j;
-            }
-        }
+    //-- Look for center and radius
+    cv::Point best_center;
+    float best_distance = search_area.area() > 0 ? findMaximum( _palm_distance( search_area ), best_center ) : 0;
 
 
-    //-- Once best distance is found, we get the center and calculate the actual radius (only if something is found)
-    if ( best_distance > -1 )
+    //-- Once best distance is found, we get the center and the radius (only if something is found)
+    if ( best_distance > 0 )
     {
-        _max_circle_incribed_center = cv::Point( best_center.first, best_center.second );
+        _max_circle_incribed_center = box.tl() + search_area.tl() + best_center - cv::Point( 1, 1 );
         _max_circle_inscribed_radius = best_distance;
        // std::cout << "[Debug] Inscribed circle: " << _max_circle_incribed_center << " -> r =" << _max_circle_inscribed_radius << std::endl;
     }
@@ -588,8 +660,6 @@ void HandDescriptor::handPalmExtraction()
 
 void HandDescriptor::ROIExtraction( const cv::Mat& src)
 {
-    //! \todo Change definition of ROI to avoid drawing a rectangle out of the image (and therefore getting a exception)
-
     //-- Pointers for writting less (and better reading)
     int * x = &(_max_circle_incribed_center.x);
     int * y = &(_max_circle_incribed_center.y);
@@ -603,26 +673,8 @@ void HandDescriptor::ROIExtraction( const cv::Mat& src)
     int ROI_width, ROI_height;
     ROI_width = ROI_height = 7*(*r);
 
-    //-- Check for limits:
-    if (ROI_corner_x + ROI_width > src.cols)
-        ROI_width = src.cols - ROI_corner_x;
-
-    if (ROI_corner_y + ROI_height > src.rows)
-        ROI_height = src.rows - ROI_corner_y;
-
-    cv::Rect ROI_rectangle = cv::Rect( ROI_corner_x, ROI_corner_y, ROI_width, ROI_height );
-    try
-    {
-        //_hand_ROI = src( ROI_rectangle ).clone();
-        _hand_ROI = cv::Mat::zeros( src.size(), CV_8UC1);
-        cv::rectangle( _hand_ROI, ROI_rectangle, cv::Scalar( 255, 255, 255), CV_FILLED);
-    }
-    catch( std::exception& e)
-    {
-        std::cerr << "An exception ocurred, but we are crossing fingers and ignoring it... :)" << std::endl;
-    }
-
-    //cv::imshow("[Debug] Hand", _hand_ROI);
+    //-- Keep it inside the image:
+    _hand_ROI = cv::Rect( ROI_corner_x, ROI_corner_y, ROI_width, ROI_height ) & cv::Rect( 0, 0, src.cols, src.rows );
 }
 
 void HandDescriptor::defectsExtraction()
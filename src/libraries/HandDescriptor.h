@@ -30,6 +30,7 @@
 
 #include <opencv2/opencv.hpp>
 #include "handUtils.h"
+#include "connectedComponents.h"
 #include "mouse.h"
 
 
@@ -72,16 +73,32 @@ public:
      *  intuitive way.
      *
      *  \param skinMask Binary image containing the skin zones of hand candidates
+     *  \param handBox Bounding box of the hand blob, if already known (e.g. HandDetector::getHandBox())
      */
-    void operator ()(const cv::Mat& skinMask );
+    void operator ()(const cv::Mat& skinMask, const cv::Rect& handBox = cv::Rect() );
 
     /*! \brief Update the internal characteristics stored
      *
      *  Extracts all the hand characteristics and guesses the current gesture
      *
      *  \param skinMask Binary image containing the skin zones of hand candidates
+     *  \param handBox Bounding box of the hand blob, if already known. If empty, the largest blob is used
      */
-    void update(const cv::Mat& skinMask );
+    void update(const cv::Mat& skinMask, const cv::Rect& handBox = cv::Rect() );
+
+
+    //-- Mirrored output:
+    //-----------------------------------------------------------------------
+    /*! \brief Mirrors the outputs horizontally, for a frame that is processed unflipped but shown as a mirror
+     *
+     *  The center, the angle and all the plots are given in the mirrored frame, so they can be drawn on a
+     *  flipped display and used to move the cursor. The contours, the bounding box and the search window
+     *  stay in the coordinates of the processed frame, as they are fed back to the HandDetector.
+     */
+    void setMirrored( bool mirrored );
+
+    //! \brief Returns true if the outputs are mirrored
+    bool getMirrored();
 
 
     //-- Get the characteristics of the hand:
@@ -109,6 +126,16 @@ public:
     //! \brief Returns the bounding box enclosing the detected hand
     cv::Rect getBoundingBox();
 
+    /*! \brief Returns the window where the hand is expected on the next frame
+     *
+     *  The window is the last bounding box, moved by the velocity estimated by the Kalman filter and
+     *  enlarged to allow for prediction errors. It is empty if no hand was found.
+     *
+     *  \param frame_size Size of the frames, to clip the window
+     *  \param margin Fraction of the bounding box size added on each side
+     */
+    cv::Rect getSearchWindow( const cv::Size& frame_size, float margin = 0.5 );
+
     //! \brief Returns the detected gesture
     int getGesture();
 
@@ -151,25 +178,31 @@ public:
 private:
     //-- Functions that extract characteristics:
     //--------------------------------------------------------------------------
-    /*! \brief Extract the hand contours from a binary image containing hand candidates
+    /*! \brief Extract the hand contour from a binary image containing hand candidates
      *
-     *  After the contour extraction it filters out the smaller contours, that are likely to
-     *  be noise, and carries a polygon approximation to reduce the number of points in the
-     *  contour.
+     *  Only the hand blob is traced, and its contour is simplified with a polygon approximation
+     *  to reduce the number of points.
      *
      *  \param skinMask Binary image containing the hand candidates, previously filtered by a
      *  HandDetector object.
+     *  \param handBox Bounding box of the hand blob. If empty, the mask is labelled and the largest
+     *  blob is taken, if it is large enough to be a hand.
      */
-    void contourExtraction(const cv::Mat& skinMask);
+    void contourExtraction(const cv::Mat& skinMask, const cv::Rect& handBox = cv::Rect() );
 
     //! \brief Extracts the bounding boxes around the hand contour ( rectangle and rotated rectange)
     void boundingBoxExtraction();
 
-    //! \brief Finds the maximum inscribed circle of the hand contour, which describes the hand palm
+    /*! \brief Finds the maximum inscribed circle of the hand contour, which describes the hand palm
+     *
+     *  The contour is filled into a mask of its bounding box, and the center is the maximum of the distance
+     *  transform of the mask in the middle of the box. The radius is the distance from the center to the
+     *  nearest pixel outside the hand.
+     */
     void handPalmExtraction();
 
-    /*! \brief Extracts a mask of the region of interest in which the hand is contained
-     *  \param src Binary image containing the hand candidates, to extract the dimensions of the mask image
+    /*! \brief Extracts the region of interest in which the hand is contained
+     *  \param src Binary image containing the hand candidates, to clip the region to its dimensions
      */
     void ROIExtraction( const cv::Mat& src);
 
@@ -189,11 +222,29 @@ private:
     void gestureExtraction();
 
 
+    //-- Mirroring of the outputs:
+    //--------------------------------------------------------------------------
+    //! \brief Returns the point as it is output (mirrored if needed)
+    cv::Point mirror( const cv::Point& point );
+    //! \brief Returns the point as it is output (mirrored if needed)
+    cv::Point2f mirror( const cv::Point2f& point );
+    //! \brief Returns the points as they are output (mirrored if needed)
+    std::vector< cv::Point > mirror( const std::vector< cv::Point >& points );
+    //! \brief Returns the angle (in degrees) as it is output (mirrored if needed)
+    double mirrorAngle( double angle );
+
+
     //-- Parameters that describe the hand:
     //--------------------------------------------------------------------------
     //! \brief Whether a hand was found or not:
     bool _hand_found;
 
+    //! \brief Whether the outputs are mirrored horizontally
+    bool _mirrored;
+
+    //! \brief Width of the last skin mask, to mirror the outputs
+    int _frame_width;
+
 
     //! \brief Contains the actual angle of the box enclosing the hand
     double _hand_angle;
@@ -263,8 +314,23 @@ private:
     std::vector< ConvexityDefect > _hand_convexity_defects;
 
 
-    //! \brief Mask containing ROI of the hand
-    cv::Mat _hand_ROI;
+    //! \brief ROI of the hand (a rectangle, so masking with it is just cropping)
+    cv::Rect _hand_ROI;
+
+    //! \brief Labels of the skin mask blobs (only used if the hand blob is not given)
+    cv::Mat _blob_labels;
+
+    //! \brief Statistics of the skin mask blobs (only used if the hand blob is not given)
+    std::vector< BlobStats > _blobs;
+
+    //! \brief Scratch memory for the blob labelling
+    BlobLabellingBuffers _blob_buffers;
+
+    //! \brief Filled hand contour, cropped to its bounding box plus a background border (for the palm)
+    cv::Mat _palm_mask;
+
+    //! \brief Distance transform of the palm mask
+    cv::Mat _palm_distance;
 
 
     //-- Kalman filters for smoothing:
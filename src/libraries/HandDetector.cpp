@@ -26,12 +26,41 @@
 
 #include "HandDetector.h"
 
+const unsigned int HandDetector::GECKO_SKIN_MODEL_HSV_BOX = 0;
+const unsigned int HandDetector::GECKO_SKIN_MODEL_HISTOGRAM = 1;
+const unsigned int HandDetector::GECKO_SKIN_MODEL_YCRCB_BOX = 2;
+const unsigned int HandDetector::GECKO_SKIN_MODEL_RG_BOX = 3;
+const unsigned int HandDetector::GECKO_SKIN_MODEL_BGR_BOX = 4;
+const unsigned int HandDetector::GECKO_BACKGROUND_MOG2 = 0;
+const unsigned int HandDetector::GECKO_BACKGROUND_RUNNING_AVERAGE = 1;
+
+//-- Cascade classifier features for face detection
+static const char * FACE_CASCADE_FILE = "/usr/local/share/OpenCV/haarcascades/haarcascade_frontalface_alt.xml";
+
+//-- Frames used to check a restored background against the scene
+static const int BACKGROUND_CHECK_FRAMES = 5;
+
+//-- Frames checked after an update of the skin histogram, and limits of the skin growth
+static const int SKIN_CHECK_FRAMES = 10;
+static const double SKIN_MAX_GROWTH = 2;
+static const double SKIN_MAX_INCREASE = 0.05;
+//-- Min. number of samples for an update of the skin histogram
+static const int SKIN_MIN_SAMPLES = 500;
+
+//-- Limits, smoothing and resolution of the illumination gains
+static const double ILLUMINATION_MIN_GAIN = 0.5;
+static const double ILLUMINATION_MAX_GAIN = 2;
+static const double ILLUMINATION_SMOOTHING = 0.9;
+static const int ILLUMINATION_GAIN_STEPS = 64;
+
 //--------------------------------------------------------------------------------------------------------
 //-- Constructors
 //--------------------------------------------------------------------------------------------------------
 
 HandDetector::HandDetector()
 {
+    init();
+
     //-- Std deviation multipliers:
     hue_sigma_mult = 6;
     sat_sigma_mult = 6;
@@ -40,15 +69,13 @@ HandDetector::HandDetector()
     //-- Skin color limits
     lower_limit = cv::Scalar( 0, 58, 89);
     upper_limit = cv::Scalar( 25, 173, 229);
-    hue_invert = false;
-
-    //-- Initialize cascade classifier:
-    initCascadeClassifier();
-    initBackgroundSubstractor();
+    updateSkinLUT();
 }
 
 HandDetector::HandDetector( cv::Mat& ROI)
 {
+    init();
+
     //-- Std deviation multipliers:
     hue_sigma_mult = 2;
     sat_sigma_mult = 2;
@@ -56,6 +83,62 @@ HandDetector::HandDetector( cv::Mat& ROI)
 
     //-- Skin color limits
     calibrate( ROI );
+}
+
+void HandDetector::init()
+{
+    //-- Skin model
+    skin_model = GECKO_SKIN_MODEL_HSV_BOX;
+    likelihood_cutoff = 40;
+    calibration_frames = 10;
+
+    //-- Usual skin boxes of the other color spaces
+    box_lower[GECKO_COLOR_SPACE_YCRCB] = cv::Scalar( 0, 133, 77 );
+    box_upper[GECKO_COLOR_SPACE_YCRCB] = cv::Scalar( 255, 173, 127 );
+    box_lower[GECKO_COLOR_SPACE_RG] = cv::Scalar( 92, 71, 30 );
+    box_upper[GECKO_COLOR_SPACE_RG] = cv::Scalar( 119, 93, 255 );
+    box_lower[GECKO_COLOR_SPACE_BGR] = cv::Scalar( 20, 40, 95 );
+    box_upper[GECKO_COLOR_SPACE_BGR] = cv::Scalar( 255, 255, 255 );
+
+    skin_adaptation = false;
+    skin_adaptation_period = 5;
+    skin_adaptation_rate = 0.2;
+    skin_min_similarity = 0.5;
+    last_skin_adaptation = 0;
+    skin_fraction_reference = -1;
+    skin_check_frames = 0;
+    skin_check_fraction = 0;
+
+    //-- Skin color limits are set by each constructor
+    hue_invert = false;
+
+    //-- Full-frame search
+    background_cached = false;
+    full_frame_interval = 15;
+    window_frames = 0;
+    window_background_threshold = 20;
+
+    //-- Blob filtering
+    min_blob_area = 1000;
+    max_hands = 1;
+
+    //-- Temporal fusion
+    mask_fusion = false;
+
+    //-- Illumination normalization
+    illumination_normalization = false;
+    illumination_reference_valid = false;
+    illumination_gains = cv::Scalar::all( 1 );
+
+    //-- Input
+    frame_format = FramePyramid::GECKO_FORMAT_BGR;
+
+    //-- Motion gate
+    motion_threshold = 0;
+    motion_pixel_threshold = 15;
+    motion_lut_generation = -1;
+    frame_skipped = false;
+    skipped_frames = processed_frames = 0;
 
     //-- Initialize cascade classifier:
     initCascadeClassifier();
@@ -66,6 +149,8 @@ HandDetector::HandDetector( cv::Mat& ROI)
 
 HandDetector::~HandDetector()
 {
+    delete faceWorker;
+    delete backgroundModel;
     cv::destroyWindow("Calibrating skin");
 }
 
@@ -125,11 +210,10 @@ void HandDetector::customValues(cv::VideoCapture cap)
         cv::Mat frame, cal_screen;
         if (! cap.read( frame ) )
             break;
-        cv::flip(frame,frame,1);
-
 
-        //-- Add calibration frame
+        //-- Add calibration frame (centered, so the frame is only flipped for display)
         drawCalibrationMarks(frame, cal_screen, halfSide);
+        cv::flip(cal_screen, cal_screen, 1);
 
         //-- Show calibration screen
         cv::imshow( "CUSTOM VALUES", cal_screen);
@@ -142,8 +226,16 @@ void HandDetector::customValues(cv::VideoCapture cap)
             int image_rows = frame.rows;
             int image_cols = frame.cols;
 
-            cv::Mat ROI = frame( cv::Rect( cv::Point( image_cols / 2 - halfSide,  image_rows/2 - halfSide ),
-                           cv::Point( image_cols / 2 + halfSide,  image_rows/2 + halfSide)));
+            cv::Rect box( cv::Point( image_cols / 2 - halfSide,  image_rows/2 - halfSide ),
+                          cv::Point( image_cols / 2 + halfSide,  image_rows/2 + halfSide));
+
+            //-- Stack the box of several frames, for a calibration robust to noise:
+            std::vector<cv::Mat> samples( 1, frame( box ).clone() );
+            while ( (int) samples.size() < calibration_frames && cap.read( frame ) )
+                samples.push_back( frame( box ).clone() );
+
+            cv::Mat ROI;
+            cv::vconcat( samples, ROI );
             //cv::imshow( "Test", ROI);
 
             HandDetector::calibrate( ROI );
@@ -186,30 +278,47 @@ void HandDetector::calibrationLoop(cv::VideoCapture cap)
     }
 
     //-- Create the calibration window with the trackbars
+    //-- (the histogram model only keeps the brightness limits of the box)
+    bool box_model = skin_model != GECKO_SKIN_MODEL_HISTOGRAM;
     cv::namedWindow("Calibrating skin");
-    cv::createTrackbar("H min", "Calibrating skin", &h[0], 255);
-    cv::createTrackbar("H max", "Calibrating skin", &h[1], 255);
+    if ( box_model )
+    {
+        cv::createTrackbar("H min", "Calibrating skin", &h[0], 255);
+        cv::createTrackbar("H max", "Calibrating skin", &h[1], 255);
 
-    cv::createTrackbar("S min", "Calibrating skin", &s[0], 255);
-    cv::createTrackbar("S max", "Calibrating skin", &s[1], 255);
+        cv::createTrackbar("S min", "Calibrating skin", &s[0], 255);
+        cv::createTrackbar("S max", "Calibrating skin", &s[1], 255);
+    }
 
     cv::createTrackbar("V min", "Calibrating skin", &v[0], 255);
     cv::createTrackbar("V max", "Calibrating skin", &v[1], 255);
 
+    if ( skin_model == GECKO_SKIN_MODEL_HISTOGRAM )
+        cv::createTrackbar("Likelihood", "Calibrating skin", &likelihood_cutoff, 255);
+
     while (1)
     {
         //-- Get current frame
-        cv::Mat frame, dst;
+        cv::Mat frame, dst, display;
         if (! cap.read( frame ) )
             break;
-        cv::flip(frame,frame,1);
 
         //change the skin thresholding limits using the trackbars
-        lower_limit=cv::Scalar(cv::getTrackbarPos("H min", "Calibrating skin"), cv::getTrackbarPos("S min", "Calibrating skin"), cv::getTrackbarPos("V min", "Calibrating skin"));
-        upper_limit=cv::Scalar(cv::getTrackbarPos("H max", "Calibrating skin"), cv::getTrackbarPos("S max", "Calibrating skin"), cv::getTrackbarPos("V max", "Calibrating skin"));
+        if ( box_model )
+        {
+            lower_limit[0] = cv::getTrackbarPos("H min", "Calibrating skin");
+            lower_limit[1] = cv::getTrackbarPos("S min", "Calibrating skin");
+            upper_limit[0] = cv::getTrackbarPos("H max", "Calibrating skin");
+            upper_limit[1] = cv::getTrackbarPos("S max", "Calibrating skin");
+        }
+        lower_limit[2] = cv::getTrackbarPos("V min", "Calibrating skin");
+        upper_limit[2] = cv::getTrackbarPos("V max", "Calibrating skin");
+        updateSkinLUT();
         HandDetector::filter_hand(frame, dst);
 
-        cv::imshow("Calibrating skin", dst);
+        //-- The frame is processed unflipped, only the mask shown is mirrored
+        cv::flip(dst, display, 1);
+        cv::imshow("Calibrating skin", display);
         //-- Wait for user confirmation
         char key =  cv::waitKey(delay);
         if ( key == 10 || key == 13 )
@@ -231,18 +340,18 @@ void HandDetector::calibrate(cv::Mat &ROI)
     cv::Mat HSV_ROI;
     cv::cvtColor( ROI, HSV_ROI, CV_BGR2HSV);
 
-    //-- Split HSV ROI in channels:
-    std::vector<cv::Mat> HSV_splitted;
-    cv::split( HSV_ROI, HSV_splitted);
+    //-- Histogram of each HSV channel, in a single pass:
+    ChannelStats HSV_stats( 3 );
+    HSV_stats.accumulate( HSV_ROI );
 
     //-- Calculate values:
-    int hue_mean = median( HSV_splitted[0] );
-    //int sat_mean = median( HSV_splitted[1] );
-    //int val_mean = median( HSV_splitted[2] );
+    int hue_mean = HSV_stats.median( 0 );
+    //int sat_mean = HSV_stats.median( 1 );
+    //int val_mean = HSV_stats.median( 2 );
 
-    int hue_sigma = stdDeviation( HSV_splitted[0] );
-    //int sat_sigma = stdDeviation( HSV_splitted[1] );
-    //int val_sigma = stdDeviation( HSV_splitted[2] );
+    int hue_sigma = ceil( HSV_stats.stdDeviation( 0 ) );
+    //int sat_sigma = ceil( HSV_stats.stdDeviation( 1 ) );
+    //int val_sigma = ceil( HSV_stats.stdDeviation( 2 ) );
 
     //-- Calculate limits
     int hue_lower_limit = hue_mean - hue_sigma_mult * hue_sigma / 2;
@@ -283,17 +392,355 @@ void HandDetector::calibrate(cv::Mat &ROI)
     lower_limit = cv::Scalar( hue_lower_limit, 58, 89  );
     upper_limit = cv::Scalar( hue_upper_limit, 173, 229 );
 
+    //-- The lighting of the new calibration is the new reference:
+    illumination_reference_valid = false;
+
+    //-- Learn the skin histogram, that will be used instead of the HSV box
+    skinHistogram.learn( ROI );
+    skin_model = GECKO_SKIN_MODEL_HISTOGRAM;
+
     std::cout << "[Debug] Lower limit is: " << lower_limit << std::endl;
     std::cout << "[Debug] Upper limit is: " << upper_limit << std::endl;
     std::cout << "[Debug] Inverting hue: " << hue_invert << std::endl;
+
+    updateSkinLUT();
 }
 
 
+void HandDetector::setCalibrationFrames(int frames)
+{
+    calibration_frames = std::max( frames, 1 );
+}
+
+int HandDetector::getCalibrationFrames()
+{
+    return calibration_frames;
+}
+
 void HandDetector::calibrate(cv::Scalar lower_limit, cv::Scalar upper_limit)
 {
     this->lower_limit = lower_limit;
     this->upper_limit = upper_limit;
     this->hue_invert = false;
+    this->skin_model = GECKO_SKIN_MODEL_HSV_BOX;
+
+    updateSkinLUT();
+}
+
+void HandDetector::updateSkinLUT()
+{
+    if ( skin_model == GECKO_SKIN_MODEL_HISTOGRAM && skinHistogram.isLearnt() )
+    {
+        //-- Back-project the histogram, keeping the brightness limits of the HSV range
+        skinHistogram.bake( skinLUT, likelihood_cutoff, lower_limit[2], upper_limit[2] );
+    }
+    else if ( boxColorSpace( skin_model ) != GECKO_COLOR_SPACE_HSV && boxColorSpace( skin_model ) < GECKO_COLOR_SPACES )
+    {
+        unsigned int color_space = boxColorSpace( skin_model );
+        skinLUT.build( box_lower[color_space], box_upper[color_space], false, color_space );
+    }
+    else if (hue_invert)
+    {
+        //-- If color limit is arround 0, calibrate() stores the complementary hue interval,
+        //-- so skin is what lies outside of it
+        cv::Scalar lower( upper_limit[0], lower_limit[1], lower_limit[2] );
+        cv::Scalar upper( lower_limit[0], upper_limit[1], upper_limit[2] );
+        skinLUT.build( lower, upper, true );
+    }
+    else
+    {
+        skinLUT.build( lower_limit, upper_limit );
+    }
+}
+
+void HandDetector::setSkinModel(unsigned int skin_model)
+{
+    this->skin_model = skin_model;
+    updateSkinLUT();
+}
+
+unsigned int HandDetector::getSkinModel()
+{
+    return skin_model;
+}
+
+void HandDetector::setSkinBox(unsigned int skin_model, const cv::Scalar &lower, const cv::Scalar &upper)
+{
+    unsigned int color_space = boxColorSpace( skin_model );
+    if ( color_space >= GECKO_COLOR_SPACES )
+    {
+        std::cerr << "[Error] Skin model " << skin_model << " is not a box" << std::endl;
+        return;
+    }
+
+    if ( color_space == GECKO_COLOR_SPACE_HSV )
+    {
+        lower_limit = lower;
+        upper_limit = upper;
+        hue_invert = false;
+    }
+    else
+    {
+        box_lower[color_space] = lower;
+        box_upper[color_space] = upper;
+    }
+
+    if ( this->skin_model == skin_model )
+        updateSkinLUT();
+}
+
+void HandDetector::getSkinBox(unsigned int skin_model, cv::Scalar &lower, cv::Scalar &upper)
+{
+    unsigned int color_space = boxColorSpace( skin_model );
+    if ( color_space >= GECKO_COLOR_SPACES )
+        return;
+
+    lower = color_space == GECKO_COLOR_SPACE_HSV ? lower_limit : box_lower[color_space];
+    upper = color_space == GECKO_COLOR_SPACE_HSV ? upper_limit : box_upper[color_space];
+}
+
+unsigned int HandDetector::boxColorSpace(unsigned int skin_model)
+{
+    if ( skin_model == GECKO_SKIN_MODEL_HSV_BOX )
+        return GECKO_COLOR_SPACE_HSV;
+    else if ( skin_model == GECKO_SKIN_MODEL_YCRCB_BOX )
+        return GECKO_COLOR_SPACE_YCRCB;
+    else if ( skin_model == GECKO_SKIN_MODEL_RG_BOX )
+        return GECKO_COLOR_SPACE_RG;
+    else if ( skin_model == GECKO_SKIN_MODEL_BGR_BOX )
+        return GECKO_COLOR_SPACE_BGR;
+
+    return GECKO_COLOR_SPACES;
+}
+
+void HandDetector::setLikelihoodCutoff(int cutoff)
+{
+    likelihood_cutoff = cutoff;
+    updateSkinLUT();
+}
+
+int HandDetector::getLikelihoodCutoff()
+{
+    return likelihood_cutoff;
+}
+
+void HandDetector::setSkinAdaptation(bool enabled, double period, double rate, double min_similarity)
+{
+    skin_adaptation = enabled;
+    skin_adaptation_period = period;
+    skin_adaptation_rate = rate;
+    skin_min_similarity = min_similarity;
+
+    last_skin_adaptation = cv::getTickCount() / cv::getTickFrequency();
+    skin_fraction_reference = -1;
+    skin_check_frames = 0;
+}
+
+bool HandDetector::getSkinAdaptation()
+{
+    return skin_adaptation;
+}
+
+void HandDetector::adaptSkin(const cv::Mat &frame, const std::vector<cv::Point> &handContour)
+{
+    if ( !skin_adaptation || skin_model != GECKO_SKIN_MODEL_HISTOGRAM || !skinHistogram.isLearnt() || handContour.size() < 3 )
+        return;
+
+    //-- Sample the pixels inside the hand contour (holes of the mask included):
+    //---------------------------------------------------------------------------
+    bool yuv = frame_format != FramePyramid::GECKO_FORMAT_BGR;
+    cv::Rect box = cv::boundingRect( handContour ) & cv::Rect( cv::Point(), yuv ? pyramid.size() : frame.size() );
+    if ( box.area() == 0 )
+        return;
+
+    //-- YUV frames: only the hand is converted to BGR
+    cv::Mat hand = yuv ? pyramid.bgr( box ) : frame( box );
+
+    adaptationMask.create( box.size(), CV_8UC1 );
+    adaptationMask.setTo( cv::Scalar( 0 ) );
+
+    std::vector< std::vector<cv::Point> > contours( 1, handContour );
+    cv::fillPoly( adaptationMask, contours, cv::Scalar( 255 ), 8, 0, cv::Point( -box.x, -box.y ) );
+
+    //-- Sampled as the lookup table sees them, so the model stays in the calibration lighting:
+    if ( illumination_normalization )
+    {
+        skinLUT.normalize( hand, adaptationFrame );
+        skinHistogram.accumulate( adaptationFrame, adaptationMask );
+    }
+    else
+        skinHistogram.accumulate( hand, adaptationMask );
+
+    //-- Update the model every few seconds, while no update is being checked:
+    //---------------------------------------------------------------------------
+    double now = cv::getTickCount() / cv::getTickFrequency();
+    if ( now - last_skin_adaptation < skin_adaptation_period || skin_check_frames > 0
+         || skinHistogram.getAccumulatedSamples() < SKIN_MIN_SAMPLES )
+        return;
+
+    last_skin_adaptation = now;
+
+    if ( !skinHistogram.adapt( skin_adaptation_rate, skin_min_similarity ) )
+    {
+        std::cerr << "[Warning] Skin update rejected: too far from the calibrated skin." << std::endl;
+        return;
+    }
+
+    updateSkinLUT();
+
+    skin_check_frames = SKIN_CHECK_FRAMES;
+    skin_check_fraction = 0;
+}
+
+void HandDetector::setIlluminationNormalization(bool enabled)
+{
+    illumination_normalization = enabled;
+    illumination_reference_valid = false;
+    illumination_gains = cv::Scalar::all( 1 );
+    skinLUT.setGains( illumination_gains );
+}
+
+bool HandDetector::getIlluminationNormalization()
+{
+    return illumination_normalization;
+}
+
+void HandDetector::updateIlluminationGains()
+{
+    //-- The mean color is robust enough on the smallest level of the pyramid:
+    cv::Scalar mean = cv::mean( pyramid.bgr( FramePyramid::GECKO_LEVEL_QUARTER ) );
+
+    if ( !illumination_reference_valid )
+    {
+        illumination_reference = mean;
+        illumination_reference_valid = true;
+        illumination_gains = cv::Scalar::all( 1 );
+        skinLUT.setGains( illumination_gains );
+        return;
+    }
+
+    //-- Von Kries correction towards the calibration lighting, smoothed and limited:
+    cv::Scalar gains;
+    for ( int c = 0; c < 3; c++ )
+    {
+        double target = mean[c] > 1 ? illumination_reference[c] / mean[c] : ILLUMINATION_MAX_GAIN;
+        target = std::min( std::max( target, ILLUMINATION_MIN_GAIN ), ILLUMINATION_MAX_GAIN );
+        illumination_gains[c] = ILLUMINATION_SMOOTHING * illumination_gains[c] + ( 1 - ILLUMINATION_SMOOTHING ) * target;
+
+        //-- Quantized, so that the gain tables are not rebuilt for tiny changes:
+        gains[c] = cvRound( illumination_gains[c] * ILLUMINATION_GAIN_STEPS ) / (double) ILLUMINATION_GAIN_STEPS;
+    }
+
+    skinLUT.setGains( gains );
+}
+
+bool HandDetector::saveProfile(const std::string &file)
+{
+    cv::FileStorage fs( file, cv::FileStorage::WRITE );
+    if ( !fs.isOpened() )
+    {
+        std::cerr << "[Error] Could not save calibration profile to " << file << std::endl;
+        return false;
+    }
+
+    fs << "lower_limit" << "[:" << (int) lower_limit[0] << (int) lower_limit[1] << (int) lower_limit[2] << "]";
+    fs << "upper_limit" << "[:" << (int) upper_limit[0] << (int) upper_limit[1] << (int) upper_limit[2] << "]";
+    fs << "hue_invert" << (int) hue_invert;
+    fs << "sigma_mult" << "[:" << hue_sigma_mult << sat_sigma_mult << val_sigma_mult << "]";
+    fs << "skin_model" << (int) skin_model;
+    fs << "likelihood_cutoff" << likelihood_cutoff;
+
+    unsigned int color_space = boxColorSpace( skin_model );
+    if ( color_space != GECKO_COLOR_SPACE_HSV && color_space < GECKO_COLOR_SPACES )
+    {
+        const cv::Scalar& lower = box_lower[color_space];
+        const cv::Scalar& upper = box_upper[color_space];
+        fs << "box_lower" << "[:" << (int) lower[0] << (int) lower[1] << (int) lower[2] << "]";
+        fs << "box_upper" << "[:" << (int) upper[0] << (int) upper[1] << (int) upper[2] << "]";
+    }
+
+    if ( skinHistogram.isLearnt() )
+    {
+        fs << "histogram";
+        skinHistogram.write( fs );
+    }
+
+    return true;
+}
+
+bool HandDetector::loadProfile(const std::string &file)
+{
+    cv::FileStorage fs( file, cv::FileStorage::READ );
+    if ( !fs.isOpened() || fs["lower_limit"].size() != 3 || fs["upper_limit"].size() != 3 )
+    {
+        std::cerr << "[Error] Could not load calibration profile from " << file << std::endl;
+        return false;
+    }
+
+    //-- The histogram model needs a valid histogram:
+    unsigned int new_skin_model = (int) fs["skin_model"];
+    if ( new_skin_model == GECKO_SKIN_MODEL_HISTOGRAM && !skinHistogram.read( fs["histogram"] ) )
+    {
+        std::cerr << "[Error] Calibration profile " << file << " has no valid skin histogram" << std::endl;
+        return false;
+    }
+
+    cv::FileNode lower = fs["lower_limit"], upper = fs["upper_limit"], sigma = fs["sigma_mult"];
+    lower_limit = cv::Scalar( (int) lower[0], (int) lower[1], (int) lower[2] );
+    upper_limit = cv::Scalar( (int) upper[0], (int) upper[1], (int) upper[2] );
+    hue_invert = (int) fs["hue_invert"] != 0;
+
+    if ( sigma.size() == 3 )
+    {
+        hue_sigma_mult = (int) sigma[0];
+        sat_sigma_mult = (int) sigma[1];
+        val_sigma_mult = (int) sigma[2];
+    }
+
+    if ( !fs["likelihood_cutoff"].empty() )
+        likelihood_cutoff = (int) fs["likelihood_cutoff"];
+
+    unsigned int color_space = boxColorSpace( new_skin_model );
+    if ( color_space != GECKO_COLOR_SPACE_HSV && color_space < GECKO_COLOR_SPACES
+         && fs["box_lower"].size() == 3 && fs["box_upper"].size() == 3 )
+    {
+        cv::FileNode box_lo = fs["box_lower"], box_up = fs["box_upper"];
+        box_lower[color_space] = cv::Scalar( (int) box_lo[0], (int) box_lo[1], (int) box_lo[2] );
+        box_upper[color_space] = cv::Scalar( (int) box_up[0], (int) box_up[1], (int) box_up[2] );
+    }
+
+    skin_model = new_skin_model == GECKO_SKIN_MODEL_HISTOGRAM || color_space < GECKO_COLOR_SPACES ? new_skin_model : GECKO_SKIN_MODEL_HSV_BOX;
+    updateSkinLUT();
+    illumination_reference_valid = false;
+    return true;
+}
+
+void HandDetector::checkSkinAdaptation(const BitMask &skin)
+{
+    //-- Window masks are measured against the whole frame too, so that
+    //-- every frame reports the same quantity:
+    double fraction = skin.count() / (double) pyramid.size().area();
+
+    //-- No update being checked, learn the usual amount of skin:
+    if ( skin_check_frames == 0 )
+    {
+        skin_fraction_reference = skin_fraction_reference < 0 ? fraction : 0.95 * skin_fraction_reference + 0.05 * fraction;
+        return;
+    }
+
+    skin_check_fraction += fraction;
+    if ( --skin_check_frames > 0 )
+        return;
+
+    double mean_fraction = skin_check_fraction / SKIN_CHECK_FRAMES;
+    if ( skin_fraction_reference >= 0
+         && mean_fraction > std::max( skin_fraction_reference * SKIN_MAX_GROWTH, skin_fraction_reference + SKIN_MAX_INCREASE ) )
+    {
+        std::cerr << "[Warning] Skin update rolled back: skin area grew from " << skin_fraction_reference
+                  << " to " << mean_fraction << std::endl;
+        skinHistogram.rollback();
+        updateSkinLUT();
+    }
 }
 
 void HandDetector::getCalibration(cv::Scalar &lower_limit, cv::Scalar &upper_limit)
@@ -320,62 +767,216 @@ void HandDetector::operator ()(cv::Mat& src, cv::Mat& dst)
 
 void HandDetector::filter_hand(cv::Mat &src, cv::Mat &dst)
 {
-    static int it=0;
+    //-- Scaled / greyscale versions are computed when a stage first asks for them:
+    pyramid.setFrame( src, frame_format );
+    cv::Size size = pyramid.size();
+
+    //-- Reuse the last mask if nothing moved:
+    //------------------------------------------------
+    frame_skipped = isStaticFrame( src );
+    if ( frame_skipped )
+    {
+        skipped_frames++;
+        lastMask.copyTo( dst );
+        return;
+    }
+
+    processed_frames++;
+
+    if ( illumination_normalization )
+        updateIlluminationGains();
+
+    //-- Process only the tracking window, if any, but search the full frame every few frames:
+    //------------------------------------------------
+    cv::Rect window = search_window & cv::Rect( cv::Point(), size );
+    if ( window.area() > 0 && window.area() < size.area() && window_frames < full_frame_interval )
+    {
+        window_frames++;
+        filterHandInWindow( src, dst, window );
+        if ( motion_threshold > 0 )
+            dst.copyTo( lastMask );
+        return;
+    }
+
+    //-- The background model will be updated:
+    window_frames = 0;
+    background_cached = false;
 
 
-    //-- Filter out head:
+    //-- Find the head:
     //------------------------------------------------
-    //-- Get mask
-    cv::Mat headTrackingMask;
-    filterFace( src, headTrackingMask );
-//    cv::imshow("[Debug] Face", src);
+    filterFace();
 
     //-- Background substraction:
     //------------------------------------------------
-    cv::Mat withoutBackground;
-    backgroundSubstraction( src, withoutBackground );
+    backgroundSubstraction( src, workspace.foregroundBits );
 
-    //-- Skin thresholding
+    //-- Skin thresholding of the foreground only, without the head:
     //------------------------------------------------
-    cv::Mat thresholdedHand;
-    threshold( withoutBackground, thresholdedHand );
+    if ( frame_format == FramePyramid::GECKO_FORMAT_BGR )
+        threshold( src, workspace.foregroundBits, workspace.thresholded );
+    else
+        skinLUT.apply( src, frame_format, workspace.foregroundBits, workspace.thresholded );
+    maskFaces( workspace.thresholded );
+
+    if ( skin_adaptation )
+        checkSkinAdaptation( workspace.thresholded );
 
-    //-- Filter out small blobs:
+    //-- Temporal vote, against flickering noise:
     //------------------------------------------------
-    cv::Mat withoutBlobs;
-    filterBlobs( thresholdedHand, withoutBlobs );
+    if ( mask_fusion )
+        maskFusion.apply( workspace.thresholded );
+
+    //-- Filter out small blobs, straight into the output:
+    //------------------------------------------------
+    filterBlobs( workspace.thresholded, dst );
+
+    //-- Kept only for the motion gate, to be reused on static frames:
+    if ( motion_threshold > 0 )
+        dst.copyTo( lastMask );
+}
+
+
+
+bool HandDetector::isStaticFrame(const cv::Mat &src)
+{
+    //-- Gate disabled: no need for the reference frame
+    if ( motion_threshold <= 0 )
+        return false;
+
+    const cv::Mat& grey = pyramid.grey( FramePyramid::GECKO_LEVEL_QUARTER );
+
+    bool unchanged = lastMask.size() == pyramid.size()
+                     && motionReference.size() == grey.size()
+                     && motion_lut_generation == skinLUT.getGeneration();
+
+    //-- Count the downsampled pixels that changed since the last frame processed (a mean over the whole
+    //-- frame would hide a small hand moving):
+    if ( unchanged )
+    {
+        cv::absdiff( grey, motionReference, motionDifference );
+        cv::threshold( motionDifference, motionDifference, motion_pixel_threshold, 255, cv::THRESH_BINARY );
+        unchanged = cv::countNonZero( motionDifference ) < motion_threshold * grey.total();
+    }
+
+    if ( !unchanged )
+    {
+        grey.copyTo( motionReference );
+        motion_lut_generation = skinLUT.getGeneration();
+    }
 
-    cv::Mat dummy;
-    cv::bitwise_and( withoutBlobs, headTrackingMask, dummy );
+    return unchanged;
+}
+
+void HandDetector::setMotionThreshold(double min_changed_fraction, int pixel_threshold)
+{
+    motion_threshold = min_changed_fraction;
+    motion_pixel_threshold = pixel_threshold;
 
-//    static cv::Mat sum=cv::Mat::zeros(dummy.rows, dummy.cols,dummy.type());
-//    static cv::Mat last_sum=cv::Mat::zeros(dummy.rows, dummy.cols,dummy.type());
+    //-- Without the gate, the buffers are not updated anymore:
+    if ( motion_threshold <= 0 )
+    {
+        lastMask.release();
+        motionReference.release();
+    }
+}
 
-//-- Average the thresholded images of different frames to reduce random noise
-//    if (it <3)
-//    {
-//        sum+=dummy;
-//        it++;
+bool HandDetector::frameSkipped()
+{
+    return frame_skipped;
+}
+
+long HandDetector::getSkippedFrames()
+{
+    return skipped_frames;
+}
 
-//    }
-//    else
-//    {
-//        it=0;
-//        sum.copyTo(last_sum);
-//        dummy.copyTo(sum);
+long HandDetector::getProcessedFrames()
+{
+    return processed_frames;
+}
+
+void HandDetector::filterHandInWindow(cv::Mat &src, cv::Mat &dst, const cv::Rect &window)
+{
+    //-- Only the window is converted to BGR if the frame is in YUV:
+    cv::Mat srcWindow = pyramid.bgr( window );
+    cv::Size size = pyramid.size();
+
+    //-- Background substraction against the last background image:
+    //------------------------------------------------
+    if ( !background_cached )
+    {
+        backgroundModel->getBackgroundImage( backgroundImage );
+        if ( !backgroundImage.empty() && backgroundImage.size() != size )
+            cv::resize( backgroundImage, backgroundImage, size );
+        background_cached = true;
+    }
+
+    if ( backgroundImage.size() == size && backgroundImage.type() == srcWindow.type() )
+    {
+        workspace.difference.create( size, srcWindow.type() );
+        workspace.differenceGrey.create( size, CV_8UC1 );
+        cv::Mat difference = workspace.difference( window );
+        cv::Mat differenceGrey = workspace.differenceGrey( window );
+
+        cv::absdiff( srcWindow, backgroundImage( window ), difference );
+        cv::cvtColor( difference, differenceGrey, CV_BGR2GRAY );
+        cv::threshold( differenceGrey, differenceGrey, window_background_threshold, 255, CV_THRESH_BINARY );
+
+        //-- Skin thresholding of the foreground only:
+        workspace.foregroundBits.fromMat( differenceGrey );
+        threshold( srcWindow, workspace.foregroundBits, workspace.thresholded );
+    }
+    else
+    {
+        threshold( srcWindow, workspace.thresholded );
+    }
 
-//    }
+    //-- Remove the head (using the last faces found):
+    //------------------------------------------------
+    maskFaces( workspace.thresholded, window.tl() );
 
-//    last_sum.copyTo(dst);
+    if ( skin_adaptation )
+        checkSkinAdaptation( workspace.thresholded );
 
+    //-- Temporal vote, kept at full size (nothing is seen outside the window):
+    //------------------------------------------------
+    if ( mask_fusion )
+    {
+        workspace.fused.create( size.height, size.width );
+        workspace.fused.setTo( false );
+        workspace.thresholded.copyTo( workspace.fused, window.tl() );
 
-    dummy.copyTo(dst);
+        maskFusion.apply( workspace.fused );
+        workspace.thresholded.copyFrom( workspace.fused, window );
+    }
 
-    //    std::cerr<<"Iterator number: "<<it<<std::endl;
+    //-- Blob filtering, straight into the full-size output:
+    //------------------------------------------------
+    dst.create( size, CV_8UC1 );
+    dst.setTo( cv::Scalar( 0 ) );
+    cv::Mat dstWindow = dst( window );
+    filterBlobs( workspace.thresholded, dstWindow, window.tl() );
+}
 
+void HandDetector::setSearchWindow(const cv::Rect &window)
+{
+    search_window = window;
+}
 
+cv::Rect HandDetector::getSearchWindow()
+{
+    return search_window;
+}
 
+void HandDetector::setFullFrameInterval(int frames)
+{
+    full_frame_interval = frames;
+}
 
+void HandDetector::setWindowBackgroundThreshold(int threshold)
+{
+    window_background_threshold = threshold;
 }
 
 
@@ -388,7 +989,7 @@ void HandDetector::filter_hand(cv::Mat &src, cv::Mat &dst)
 void HandDetector::initCascadeClassifier( )
 {
     //-- Load file with the classifier features:
-    if ( ! faceDetector.load( "/usr/local/share/OpenCV/haarcascades/haarcascade_frontalface_alt.xml" ) )
+    if ( ! faceDetector.load( FACE_CASCADE_FILE ) )
     {
 	std::cerr << "[Error] Could not load cascade classifier features file." << std::endl;
     }
@@ -397,54 +998,78 @@ void HandDetector::initCascadeClassifier( )
     factorX = 1.25;
     factorY = 1.25;
 
+    //-- Run the detector every 10 frames, track faces in between
+    face_detection_period = 10;
+    face_tracking_threshold = 0.6;
+    frames_since_detection = face_detection_period; //-- Detect on the first frame
+
+    //-- Synchronous detection by default
+    faceWorker = NULL;
+    frame_count = 0;
+    faces_frame = 0;
+
 }
 
 //-- Filter out faces:
-void HandDetector::filterFace(const cv::Mat &src, cv::Mat &dstMask )
+void HandDetector::filterFace()
 {
-    //-- Create variables to store faces
-    std::vector< cv::Rect > detectedFaces;
+    //-- Faces are searched for on the quarter resolution greyscale image:
+    const cv::Mat& srcGreySmall = pyramid.grey( FramePyramid::GECKO_LEVEL_QUARTER );
 
-    //-- Convert the source image to a greyscale image:
-    cv::Mat srcGrey;
-    cv::cvtColor( src, srcGrey, CV_BGR2GRAY );
+    frame_count++;
+    frames_since_detection++;
 
-    cv::Mat srcGreySmall;
-    cv::resize( srcGrey, srcGreySmall, cv::Size(0, 0), 0.25, 0.25 );
+    //-- Take the newest faces published by the worker thread, if any:
+    cv::Mat detectionGreySmall;
+    long detection_frame;
+    if ( faceWorker && faceWorker->fetch( facesSmall, detectionGreySmall, detection_frame ) )
+    {
+        storeFaceTemplates( detectionGreySmall );
+        faces_frame = detection_frame;
+    }
 
-    //-- Detect face:
-    faceDetector.detectMultiScale( srcGreySmall, detectedFaces, 1.1, 2, 0|CV_HAAR_SCALE_IMAGE, cv::Size( 30, 30) );
+    //-- Track faces, and detect them again when it is time or a face was lost:
+    bool tracked = trackFaces( srcGreySmall );
 
-    dstMask = cv::Mat(  srcGrey.size() , CV_8UC1,  cv::Scalar( 255, 255, 255) );
+    if ( !tracked || frames_since_detection >= face_detection_period )
+    {
+        if ( faceWorker )
+        {
+            faceWorker->submit( srcGreySmall, frame_count );
+            frames_since_detection = 0;
+        }
+        else
+            detectFaces( srcGreySmall );
+    }
 
     //-- Clear detected faces:
     lastFacesPos.clear();
 
     //-- Show detected faces:
-    if ( ! detectedFaces.empty() )
+    if ( ! facesSmall.empty() )
     {
-	for (int i = 0; i < detectedFaces.size(); i++)
+	for (int i = 0; i < facesSmall.size(); i++)
 	{
 	    cv::Rect resizedRect;
 
 	    if ( factorX == 1 && factorY == 1 )
 	    {
 		//-- Do not resize:
-		resizedRect = cv::Rect( detectedFaces[i].x * 4,
-					detectedFaces[i].y * 4,
-					detectedFaces[i].width  * 4,
-					detectedFaces[i].height * 4 );
+		resizedRect = cv::Rect( facesSmall[i].x * 4,
+					facesSmall[i].y * 4,
+					facesSmall[i].width  * 4,
+					facesSmall[i].height * 4 );
 	    }
 	    else
 	    {
 		//-- Resize:
 		//-- Calculate original center:
-		double cx = detectedFaces[i].x * 4 + detectedFaces[i].width * 2;
-		double cy = detectedFaces[i].y * 4 + detectedFaces[i].height * 2;
+		double cx = facesSmall[i].x * 4 + facesSmall[i].width * 2;
+		double cy = facesSmall[i].y * 4 + facesSmall[i].height * 2;
 
 		//-- Calculate new size:
-		double newW = detectedFaces[i].width * 4 * factorX;
-		double newH = detectedFaces[i].width * 4 * factorY;
+		double newW = facesSmall[i].width * 4 * factorX;
+		double newH = facesSmall[i].width * 4 * factorY;
 
 		//-- Calculate new center:
 		double newX = cx - newW / 2;
@@ -453,14 +1078,100 @@ void HandDetector::filterFace(const cv::Mat &src, cv::Mat &dstMask )
 		resizedRect = cv::Rect( newX, newY, newW, newH );
 	    }
 
-	    cv::rectangle( dstMask, resizedRect, cv::Scalar( 0, 0, 0), CV_FILLED );
-
 	    //-- Save rectancle
 	    lastFacesPos.push_back( resizedRect );
 	}
     }
 }
 
+void HandDetector::maskFaces(BitMask &mask, const cv::Point &offset)
+{
+    //-- Whole words are cleared at once:
+    for ( int i = 0; i < lastFacesPos.size(); i++ )
+        mask.setTo( lastFacesPos[i] - offset, false );
+}
+
+void HandDetector::detectFaces(const cv::Mat &srcGreySmall)
+{
+    //-- Detect face:
+    faceDetector.detectMultiScale( srcGreySmall, facesSmall, 1.1, 2, 0|CV_HAAR_SCALE_IMAGE, cv::Size( 30, 30) );
+
+    storeFaceTemplates( srcGreySmall );
+
+    faces_frame = frame_count;
+    frames_since_detection = 0;
+}
+
+void HandDetector::storeFaceTemplates(const cv::Mat &srcGreySmall)
+{
+    faceTemplates.clear();
+    for ( int i = 0; i < facesSmall.size(); i++ )
+        faceTemplates.push_back( srcGreySmall( facesSmall[i] ).clone() );
+}
+
+bool HandDetector::trackFaces(const cv::Mat &srcGreySmall)
+{
+    const cv::Rect image( 0, 0, srcGreySmall.cols, srcGreySmall.rows );
+
+    for ( int i = 0; i < facesSmall.size(); i++ )
+    {
+        //-- Search around the last position:
+        int margin_x = std::max( 4, facesSmall[i].width / 4 );
+        int margin_y = std::max( 4, facesSmall[i].height / 4 );
+        cv::Rect searchRect = cv::Rect( facesSmall[i].x - margin_x, facesSmall[i].y - margin_y,
+                                        facesSmall[i].width + 2 * margin_x, facesSmall[i].height + 2 * margin_y ) & image;
+
+        if ( searchRect.width < faceTemplates[i].cols || searchRect.height < faceTemplates[i].rows )
+            return false;
+
+        //-- Find the best match:
+        cv::matchTemplate( srcGreySmall( searchRect ), faceTemplates[i], workspace.matchResult, CV_TM_CCOEFF_NORMED );
+
+        double maxValue;
+        cv::Point maxLocation;
+        cv::minMaxLoc( workspace.matchResult, 0, &maxValue, 0, &maxLocation );
+
+        if ( maxValue < face_tracking_threshold )
+            return false;
+
+        facesSmall[i].x = searchRect.x + maxLocation.x;
+        facesSmall[i].y = searchRect.y + maxLocation.y;
+    }
+
+    return true;
+}
+
+void HandDetector::setFaceDetectionPeriod(int period, double tracking_threshold)
+{
+    face_detection_period = period;
+    face_tracking_threshold = tracking_threshold;
+}
+
+void HandDetector::setAsyncFaceDetection(bool enable)
+{
+    if ( enable && !faceWorker )
+    {
+        faceWorker = new FaceDetectorWorker( FACE_CASCADE_FILE );
+
+        if ( !faceWorker->isRunning() )
+        {
+            std::cerr << "[Error] Face detection will run synchronously." << std::endl;
+            delete faceWorker;
+            faceWorker = NULL;
+        }
+    }
+    else if ( !enable && faceWorker )
+    {
+        delete faceWorker;
+        faceWorker = NULL;
+    }
+}
+
+int HandDetector::getFacesAge()
+{
+    return frame_count - faces_frame;
+}
+
 
 //-- Return last faces found
 std::vector< cv::Rect >& HandDetector::getLastFacesPos()
@@ -470,7 +1181,7 @@ std::vector< cv::Rect >& HandDetector::getLastFacesPos()
 
 
 //-- Plot the last faces found marks
-void HandDetector::drawFaceMarks(const cv::Mat &src, cv::Mat &dst, cv::Scalar color, int thickness )
+void HandDetector::drawFaceMarks(const cv::Mat &src, cv::Mat &dst, cv::Scalar color, int thickness, bool mirrored )
 {
     //-- Allocate the dst matrix if empty:
     if ( dst.total() == 0)
@@ -481,7 +1192,13 @@ void HandDetector::drawFaceMarks(const cv::Mat &src, cv::Mat &dst, cv::Scalar co
     {
 	std::cout << "[Debug] Detected " << lastFacesPos.size() << " face(s)." << std::endl;
 	for ( int i = 0; i < lastFacesPos.size(); i++)
-	    cv::rectangle( dst, lastFacesPos[i], color, thickness );
+	{
+	    cv::Rect face = lastFacesPos[i];
+	    if ( mirrored )
+	        face.x = dst.cols - face.x - face.width;
+
+	    cv::rectangle( dst, face, color, thickness );
+	}
     }
 
 }
@@ -497,116 +1214,182 @@ cv::Scalar HandDetector:: getUpper()
 
 
 
-//--------------------------------------------------------------------------------------------------------
-//-- Statistical functions:
-//--------------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------------------
+//-- Hand-filtering functions
+//-------------------------------------------------------------------------------------------------------------
+void HandDetector::initBackgroundSubstractor()
+{
+    backgroundModel = NULL;
+    setBackgroundModel( GECKO_BACKGROUND_MOG2 );
+
+    //-- Half resolution is enough for the model, and four times cheaper
+    background_level = FramePyramid::GECKO_LEVEL_HALF;
+
+}
 
-int HandDetector::average(cv::Mat &ROI)
+void HandDetector::backgroundSubstraction(cv::Mat &src, BitMask &dst)
 {
-    //-- Calculate average value
-    double average = 0;
+    //-- Run the model on the selected level, and scale the foreground mask back up if needed:
+    backgroundModel->apply( pyramid.bgr( background_level ), workspace.foreground );
 
-    for (int i = 0; i < ROI.cols; i++ )
-	for( int j = 0; j < ROI.rows; j++)
-	    average += (int) ROI.at<unsigned char>(i, j);
+    //-- Discard a restored background that does not match the scene:
+    if ( background_check_frames > 0 )
+        checkRestoredBackground( workspace.foreground );
 
+    if ( background_level == FramePyramid::GECKO_LEVEL_FULL )
+        workspace.foregroundFull = workspace.foreground;
+    else
+        cv::resize( workspace.foreground, workspace.foregroundFull, pyramid.size(), 0, 0, cv::INTER_NEAREST );
 
-    average /= (double) (ROI.cols * ROI.rows);
-    return ceil(average);
+    //-- The frame itself is not touched: the mask is applied while thresholding
+    dst.fromMat( workspace.foregroundFull );
 }
 
-int HandDetector::median(cv::Mat &ROI)
+void HandDetector::setBackgroundModel(unsigned int type)
 {
-    //-- Unroll the ROI
-    std::vector<unsigned char> unrolled;
+    delete backgroundModel;
 
-    for (int i = 0; i < ROI.cols; i++ )
-	for( int j = 0; j < ROI.rows; j++)
-	     unrolled.push_back( ROI.at<unsigned char>(i, j) );
+    if ( type == GECKO_BACKGROUND_RUNNING_AVERAGE )
+        backgroundModel = new RunningAverageBackgroundModel();
+    else
+        backgroundModel = new MOG2BackgroundModel();
+
+    background_model_type = type;
+    background_cached = false;
+    background_check_frames = 0;
+}
 
-    //-- Sort the vector
-    std::sort( unrolled.begin(), unrolled.end() );
+unsigned int HandDetector::getBackgroundModel()
+{
+    return background_model_type;
+}
 
-    //-- Get the median
-    if ( unrolled.size() % 2 != 0)
+bool HandDetector::saveBackground(const std::string &file)
+{
+    if ( !backgroundModel->save( file ) )
     {
-	//-- Odd vector:
-	return ceil( unrolled.at( (unrolled.size() -1 ) / 2) );
+        std::cerr << "[Error] Could not save background model to " << file << std::endl;
+        return false;
     }
-    else
+
+    return true;
+}
+
+bool HandDetector::loadBackground(const std::string &file)
+{
+    if ( !backgroundModel->load( file ) )
     {
-	//-- Even vector:
-	double mean = unrolled.at( unrolled.size() / 2 ) + unrolled.at( (unrolled.size() / 2 ) - 1 );
-	mean /= 2;
-	return ceil(mean);
+        //-- The background may have been loaded partially, start again:
+        setBackgroundModel( background_model_type );
+        return false;
     }
+
+    background_check_frames = BACKGROUND_CHECK_FRAMES;
+    background_check_foreground = 0;
+    background_cached = false;
+    return true;
 }
 
-int HandDetector::stdDeviation(cv::Mat &ROI)
+void HandDetector::checkRestoredBackground(const cv::Mat &foreground)
 {
-    //-- Calculates the std deviation of the pixel values
-    double stddev = 0;
+    const double max_foreground = 0.5; //-- Max. mean fraction of foreground for the background to be valid
 
-    for (int i = 0; i < ROI.cols; i++ )
-	for( int j = 0; j < ROI.rows; j++)
-	    stddev +=  pow( (int) ROI.at<unsigned char>(i, j), 2);
+    background_check_foreground += cv::countNonZero( foreground ) / (double) foreground.total();
 
-    stddev = sqrt( stddev ) / (ROI.cols * ROI.rows);
-    return ceil(stddev);
+    if ( --background_check_frames > 0 )
+        return;
+
+    if ( background_check_foreground / BACKGROUND_CHECK_FRAMES > max_foreground )
+    {
+        std::cerr << "[Warning] Restored background does not match the scene, learning it again." << std::endl;
+        setBackgroundModel( background_model_type );
+    }
 }
 
+void HandDetector::setBackgroundLevel(unsigned int level)
+{
+    background_level = level;
+    background_cached = false;
+}
 
-//-------------------------------------------------------------------------------------------------------------
-//-- Hand-filtering functions
-//-------------------------------------------------------------------------------------------------------------
-void HandDetector::initBackgroundSubstractor()
+FramePyramid& HandDetector::getPyramid()
+{
+    return pyramid;
+}
+
+void HandDetector::setFrameFormat(unsigned int format)
 {
-    bg.set("nmixtures",3);// set number of gaussian mixtures
-    bg.set("detectShadows", true); //if false: turn shadow detection off
-    bg.setbackgroundRatio(0.000000000000001);
+    frame_format = format;
+}
 
+unsigned int HandDetector::getFrameFormat()
+{
+    return frame_format;
 }
 
-void HandDetector::backgroundSubstraction(cv::Mat &src, cv::Mat &dst)
+
+void HandDetector::threshold(const cv::Mat &src, BitMask &dst)
 {
-    dst = src.clone();
-    backgroundSubs(dst, bg);
+    //-- One table lookup per pixel (the table is kept up to date by updateSkinLUT)
+    skinLUT.apply( src, dst );
 }
 
+void HandDetector::threshold(const cv::Mat &src, const BitMask &foreground, BitMask &dst)
+{
+    //-- Background pixels are skipped, a word at a time
+    skinLUT.apply( src, foreground, dst );
+}
 
-void HandDetector::threshold(const cv::Mat &src, cv::Mat &dst)
+void HandDetector::filterBlobs(const BitMask &src, cv::Mat &dst, const cv::Point& offset)
 {
-    //-- Convert to HSV
-    cv::Mat hsv;
-    cv::cvtColor( src, hsv, CV_BGR2HSV);
+    //-- Label the blobs, and keep the ones that are large enough:
+    labelBlobs( src, blobLabels, blobs, blobBuffers );
+    keepBlobs( blobLabels, blobs, dst, min_blob_area );
 
-    //-- Threshold
-    cv::inRange(hsv, lower_limit, upper_limit, dst);
+    //-- The largest blobs are the hand candidates:
+    largestBlobs( blobs, min_blob_area, max_hands, hand_blobs );
 
-    //-- If color limit is arround 0, hue channel needs to be inverted
-    if (hue_invert)
-    {
-		std::vector< cv::Mat > hsv;
-		cv::split( dst, hsv);
-		cv::bitwise_not( hsv[0], hsv[0] );
-		//! \todo Join them again?
-    }
+    hand_boxes.resize( hand_blobs.size() );
+    for ( int i = 0; i < (int) hand_blobs.size(); i++ )
+        hand_boxes[i] = blobs[ hand_blobs[i] ].boundingBox + offset;
+
+    hand_box = hand_boxes.empty() ? cv::Rect() : hand_boxes[0];
 }
 
-void HandDetector::filterBlobs(const cv::Mat &src, cv::Mat &dst)
+cv::Rect HandDetector::getHandBox()
 {
-//    cv::Mat kernel = cv::getStructuringElement( cv::MORPH_ELLIPSE, cv::Size( 5, 5) );
-//    cv::morphologyEx( src, dst, cv::MORPH_CLOSE, kernel);
+    return hand_box;
+}
 
-    cv::GaussianBlur(src, dst,cv::Size(0,0),5);
-//    cv::adaptiveThreshold(dst, dst, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C, cv::THRESH_BINARY, 21, 5);
+std::vector<cv::Rect> HandDetector::getHandBoxes()
+{
+    return hand_boxes;
+}
 
-//    cv::threshold(dst, dst, 40, 255, CV_THRESH_BINARY | CV_THRESH_OTSU);
+void HandDetector::setMinBlobArea(int min_area)
+{
+    min_blob_area = min_area;
+}
+
+void HandDetector::setMaxHands(int max_hands)
+{
+    this->max_hands = std::max( max_hands, 1 );
+}
 
+int HandDetector::getMaxHands()
+{
+    return max_hands;
+}
 
-    int min=50;
-    cv::inRange(dst,cv::Scalar(min,min,min) , cv::Scalar(255,255,255), dst);
+void HandDetector::setMaskFusion(int length, int votes)
+{
+    maskFusion.setVote( length, votes );
+    mask_fusion = maskFusion.getLength() > 1;
+}
 
+int HandDetector::getMaskFusionLength()
+{
+    return mask_fusion ? maskFusion.getLength() : 1;
 }
 
 
@@ -30,6 +30,16 @@
 
 #include <opencv2/opencv.hpp>
 #include "handUtils.h"
+#include "SkinLUT.h"
+#include "SkinHistogram.h"
+#include "FaceDetectorWorker.h"
+#include "FramePyramid.h"
+#include "connectedComponents.h"
+#include "BitMask.h"
+#include "ChannelStats.h"
+#include "MaskFusion.h"
+#include "MOG2BackgroundModel.h"
+#include "RunningAverageBackgroundModel.h"
 
 
 /*! \class HandDetector
@@ -46,6 +56,25 @@ class HandDetector
 {
 
 public:
+    //-- Constants for the skin models
+    //-----------------------------------------------------------------------
+    //! \brief Skin is a box in the HSV color space
+    static const unsigned int GECKO_SKIN_MODEL_HSV_BOX;
+    //! \brief Skin is given by a Hue-Saturation histogram learnt from the user's skin
+    static const unsigned int GECKO_SKIN_MODEL_HISTOGRAM;
+    //! \brief Skin is a box in the YCrCb color space (no hue, so cheaper and less sensitive to noise on dark pixels)
+    static const unsigned int GECKO_SKIN_MODEL_YCRCB_BOX;
+    //! \brief Skin is a box in the normalized rg chromaticity space, plus an intensity range
+    static const unsigned int GECKO_SKIN_MODEL_RG_BOX;
+    //! \brief Skin is a box in the BGR color space
+    static const unsigned int GECKO_SKIN_MODEL_BGR_BOX;
+
+    //-- Constants for the background models
+    //-----------------------------------------------------------------------
+    //! \brief Mixture Of Gaussians (cv::BackgroundSubtractorMOG2)
+    static const unsigned int GECKO_BACKGROUND_MOG2;
+    //! \brief Exponential running average, much cheaper, for fixed cameras
+    static const unsigned int GECKO_BACKGROUND_RUNNING_AVERAGE;
 
 	//-- Constructors
     //-----------------------------------------------------------------------
@@ -75,14 +104,94 @@ public:
 	//-- Calibration functions
     //-----------------------------------------------------------------------
 
-    //! \brief Changes the HSV range accordingly with the input skin color image
+    /*! \brief Changes the HSV range and learns the skin histogram accordingly with the input skin color image
+     *
+     *  The hue range is centered on the median hue of the sample, and its width is proportional to the
+     *  standard deviation of the hue (times the hue sigma multiplier).
+     */
 	void calibrate( cv::Mat& ROI);
 
+    //! \brief Sets the number of frames of the calibration box that customValues() learns from
+    void setCalibrationFrames( int frames );
+    //! \brief Returns the number of frames of the calibration box that customValues() learns from
+    int getCalibrationFrames();
+
     //! \brief Sets the HSV skin colors range with the inputs. If there are no inputs, default values are set.
 	void calibrate( cv::Scalar lower_limit = cv::Scalar( 0, 58, 89), cv::Scalar upper_limit = cv::Scalar( 25, 173, 229) );
     //! \brief Returns the HSV range
     void getCalibration( cv::Scalar& lower_limit, cv::Scalar& upper_limit);
 
+    //! \brief Selects the skin model used for thresholding (the histogram model needs a previous calibration with a ROI)
+    void setSkinModel( unsigned int skin_model );
+    //! \brief Returns the skin model used for thresholding
+    unsigned int getSkinModel();
+
+    /*! \brief Sets the limits of one of the box skin models, without selecting it
+     *  \param skin_model One of GECKO_SKIN_MODEL_HSV_BOX, GECKO_SKIN_MODEL_YCRCB_BOX, GECKO_SKIN_MODEL_RG_BOX or GECKO_SKIN_MODEL_BGR_BOX
+     *  \param lower Lower limit, in the channel order of the color space (see thresholdBox())
+     *  \param upper Upper limit
+     */
+    void setSkinBox( unsigned int skin_model, const cv::Scalar& lower, const cv::Scalar& upper );
+    //! \brief Returns the limits of one of the box skin models
+    void getSkinBox( unsigned int skin_model, cv::Scalar& lower, cv::Scalar& upper );
+
+    //! \brief Sets the minimum likelihood [0-255] for a color to be skin with the histogram model
+    void setLikelihoodCutoff( int cutoff );
+    //! \brief Returns the minimum likelihood for a color to be skin with the histogram model
+    int getLikelihoodCutoff();
+
+    //-- Skin adaptation
+    //-----------------------------------------------------------------------
+    /*! \brief Enables the online adaptation of the skin histogram to the lighting
+     *
+     *  Only works with the histogram model. Samples given by adaptSkin() are blended into the model
+     *  every period seconds. An update too far from the calibrated skin is rejected, and an update
+     *  after which the skin area grows too much (i.e. the background starts to be taken as skin) is
+     *  rolled back.
+     *
+     *  \param enabled True to enable the adaptation
+     *  \param period Seconds between two updates of the model
+     *  \param rate Weight of the new samples in each update [0-1]
+     *  \param min_similarity Min. histogram intersection [0-1] of the updated model with the calibrated one
+     */
+    void setSkinAdaptation( bool enabled, double period = 5, double rate = 0.2, double min_similarity = 0.5 );
+
+    //! \brief Returns true if the skin adaptation is enabled
+    bool getSkinAdaptation();
+
+    /*! \brief Samples the skin of a confirmed hand for the adaptation
+     *
+     *  Call it only for reliable hands (e.g. with a recognized gesture), so that the model does not
+     *  learn from false detections.
+     *
+     *  \param frame Frame where the hand was found, as given to filter_hand()
+     *  \param handContour Contour of the hand on frame
+     */
+    void adaptSkin( const cv::Mat& frame, const std::vector<cv::Point>& handContour );
+
+    /*! \brief Enables or disables the illumination normalization
+     *
+     *  Each frame is scaled, channel by channel, so that its mean color matches the one of the
+     *  scene on calibration, which keeps the skin color stable when the lighting changes. The
+     *  reference is taken on the first frame processed after enabling it or after a calibration.
+     */
+    void setIlluminationNormalization( bool enabled );
+
+    //! \brief Returns true if the illumination normalization is enabled
+    bool getIlluminationNormalization();
+
+    //-- Calibration profiles
+    //-----------------------------------------------------------------------
+    /*! \brief Saves the skin calibration (HSV range, sigma multipliers, skin model and its histogram or box) to a file
+     *  \return False if the file could not be written
+     */
+    bool saveProfile( const std::string& file );
+
+    /*! \brief Restores a skin calibration saved with saveProfile(), so that no interactive calibration is needed
+     *  \return False if the file could not be read or is not a profile (the calibration is then unchanged)
+     */
+    bool loadProfile( const std::string& file );
+
 	//-- Hand-detection
     //-----------------------------------------------------------------------
     /*! \brief Update the segmented hand binary image
@@ -98,11 +207,40 @@ public:
      *
      *  Removes the background, thresholds the skin color and makes morphology transformations to improve the binary output image
      *
-     *  \param src Original image coming from the video input.
+     *  \param src Original image coming from the video input, in the format set by setFrameFormat().
      *  \param dst Final binary image containing the segmented image.
      */
     void filter_hand(cv::Mat& src, cv::Mat& dst);
 
+    //-- Tracking mode
+    //-----------------------------------------------------------------------
+    /*! \brief Restricts the hand search to a window of the frame
+     *
+     *  While a window is set, all the filtering stages run only inside it (the faces and the background
+     *  are taken from the last full-frame search). An empty window means full-frame search, which is the
+     *  fall back when the hand is lost. A full-frame search is also forced periodically, to keep the
+     *  background model and the faces up to date (see setFullFrameInterval()).
+     *
+     *  \param window Window where the hand is expected, usually HandDescriptor::getSearchWindow()
+     */
+    void setSearchWindow( const cv::Rect& window );
+    //! \brief Returns the window where the hand is searched for (empty for full-frame search)
+    cv::Rect getSearchWindow();
+
+    /*! \brief Sets how often a full-frame search is done while tracking
+     *
+     *  The full-frame search updates the background model, the background image used in the window and
+     *  the faces, so the window segmentation does not drift from the full-frame one.
+     *
+     *  \param frames Max. number of consecutive frames searched only inside the window
+     */
+    void setFullFrameInterval( int frames );
+
+    /*! \brief Sets the min. difference with the background for a pixel of the window to be foreground
+     *  \param threshold Grey level of the difference with the background image
+     */
+    void setWindowBackgroundThreshold( int threshold );
+
 	//-- Face-tracking
     //-----------------------------------------------------------------------
     //! \brief Returns the last position of the face
@@ -116,8 +254,132 @@ public:
      *  \param dst Output image with the squares over the faces.
      *  \param color Color of the squares, default is black.
      *  \param thickness Thickness of the square drawn over the faces.
+     *  \param mirrored True if dst is the processed frame flipped horizontally.
+     */
+	void drawFaceMarks( const cv::Mat& src, cv::Mat& dst , cv::Scalar color = cv::Scalar(0, 255, 0), int thickness = 1, bool mirrored = false );
+
+    /*! \brief Sets how often the face detector is run
+     *
+     *  In between, the faces are tracked with template matching, and the detector is only run earlier
+     *  if a face is lost.
+     *
+     *  \param period Number of frames between two runs of the face detector (1 runs it every frame)
+     *  \param tracking_threshold Minimum normalized correlation [0-1] for a face to be considered tracked
+     */
+    void setFaceDetectionPeriod( int period, double tracking_threshold = 0.6 );
+
+    /*! \brief Runs the face detector on a background thread
+     *
+     *  The hand filtering never waits for the detector: it keeps tracking the newest faces published
+     *  by the worker thread, which may be a few frames old (see getFacesAge()).
+     */
+    void setAsyncFaceDetection( bool enable );
+
+    //! \brief Returns how many frames ago the faces currently masked were detected
+    int getFacesAge();
+
+    //-- Motion gate
+    //-----------------------------------------------------------------------
+    /*! \brief Sets the min. change between frames for the hand to be searched for again
+     *
+     *  The pixels of the quarter resolution greyscale frame that differ from the last frame processed
+     *  by more than pixel_threshold are counted. If they are fewer than the given fraction of the frame,
+     *  the frame is considered static and the last mask is returned without running any stage.
+     *
+     *  A small hand moving across the frame only changes a few percent of the pixels, so the fraction
+     *  must be well below that (e.g. 0.002). The gate is disabled by default.
+     *
+     *  \param min_changed_fraction Min. fraction of changed pixels to process a frame (0 disables the gate)
+     *  \param pixel_threshold Min. absolute difference, in grey levels, for a pixel to count as changed
      */
-	void drawFaceMarks( const cv::Mat& src, cv::Mat& dst , cv::Scalar color = cv::Scalar(0, 255, 0), int thickness = 1  );
+    void setMotionThreshold( double min_changed_fraction, int pixel_threshold = 15 );
+
+    //! \brief Returns true if the last frame was static, so its mask (and hand) are the previous ones
+    bool frameSkipped();
+
+    //! \brief Returns the number of frames skipped by the motion gate
+    long getSkippedFrames();
+
+    //! \brief Returns the number of frames fully processed
+    long getProcessedFrames();
+
+    //-- Hand blob
+    //-----------------------------------------------------------------------
+    //! \brief Returns the bounding box of the largest blob of the last mask (empty if none), for HandDescriptor
+    cv::Rect getHandBox();
+
+    //! \brief Returns the bounding boxes of the largest blobs of the last mask, largest first (at most getMaxHands())
+    std::vector<cv::Rect> getHandBoxes();
+
+    //! \brief Sets the min. number of pixels of a blob for it to be kept in the mask
+    void setMinBlobArea( int min_area );
+
+    //! \brief Sets the max. number of hand candidates returned by getHandBoxes()
+    void setMaxHands( int max_hands );
+
+    //! \brief Returns the max. number of hand candidates returned by getHandBoxes()
+    int getMaxHands();
+
+    //-- Temporal fusion
+    //-----------------------------------------------------------------------
+    /*! \brief Keeps only the skin pixels found in at least votes of the last length frames processed
+     *
+     *  Removes the noise that flickers from frame to frame, before the blobs are filtered. The vote
+     *  costs a few word operations per 64 pixels, whatever its length.
+     *
+     *  \param length Number of frames in the vote (1 disables the fusion, max. MaskFusion::MAX_LENGTH)
+     *  \param votes Min. number of frames in which a pixel must be skin
+     */
+    void setMaskFusion( int length, int votes );
+
+    //! \brief Returns the number of frames in the temporal vote (1 if disabled)
+    int getMaskFusionLength();
+
+    //-- Frame pyramid
+    //-----------------------------------------------------------------------
+    //! \brief Returns the scaled / greyscale versions of the last frame processed, to be reused outside
+    FramePyramid& getPyramid();
+
+    /*! \brief Sets the format of the frames given to filter_hand()
+     *
+     *  With YUYV or NV12 frames (as delivered by the camera), the skin is tested in YUV and the faces are
+     *  searched for on the Y plane, so the frame is never converted to BGR as a whole (only the half
+     *  resolution level for the background model, and the search window while tracking).
+     *
+     *  \param format One of the FramePyramid::GECKO_FORMAT_* constants
+     */
+    void setFrameFormat( unsigned int format );
+
+    //! \brief Returns the format of the frames given to filter_hand()
+    unsigned int getFrameFormat();
+
+    /*! \brief Selects the background model, starting it from scratch
+     *  \param type One of GECKO_BACKGROUND_MOG2 or GECKO_BACKGROUND_RUNNING_AVERAGE
+     */
+    void setBackgroundModel( unsigned int type );
+
+    //! \brief Returns the type of the background model in use
+    unsigned int getBackgroundModel();
+
+    /*! \brief Saves the learnt background, so that the next run does not start from scratch
+     *  \return False if the file could not be written
+     */
+    bool saveBackground( const std::string& file );
+
+    /*! \brief Restores a background saved with saveBackground()
+     *
+     *  The first frames after restoring are checked against the model: if most of the image looks
+     *  like foreground, the snapshot is considered stale (e.g. the camera or the lights changed),
+     *  and the background is learnt again from scratch.
+     *
+     *  \return False if the file could not be read or belongs to a different background model
+     */
+    bool loadBackground( const std::string& file );
+
+    /*! \brief Sets the pyramid level where the background model runs
+     *  \param level One of FramePyramid::GECKO_LEVEL_FULL, GECKO_LEVEL_HALF or GECKO_LEVEL_QUARTER
+     */
+    void setBackgroundLevel( unsigned int level );
 	
     //-- Get lower and upper level (calibration)
     //-----------------------------------------------------------------------
@@ -128,45 +390,177 @@ public:
 
 
     private:
-	//-- Statistical functions:
-    //! \todo OpenCV already has this functions, so use them instead.
-    //! \brief Returns the average of the pixel's values
-	int average( cv::Mat& ROI);
-    //! \brief Returns the median of the pixel's values
-	int median( cv::Mat& ROI);
-    //! \brief Returns the standard deviation of the pixel's values
-	int stdDeviation( cv::Mat& ROI);
+    //! \brief Sets the members shared by both constructors (everything but the skin color limits)
+    void init();
+
+    //-- The face worker and the background model are owned, so copies are not allowed:
+    HandDetector( const HandDetector& );
+    HandDetector& operator=( const HandDetector& );
+
 
 	//-- Hand filtering functions:
     //-----------------------------------------------------------------------
-    /*! \brief Thresholds the input image using the HSV range
+    /*! \brief Thresholds the input image using the skin lookup table (built from the HSV range)
      *
      *  \param src Input image
-     *  \param dst Binary output image
+     *  \param dst Bit-packed output mask
      */
-	void threshold( const cv::Mat& src, cv::Mat& dst);
-    /*! \brief Applies Gaussian Blur and thresholding to improve the final binary image
+	void threshold( const cv::Mat& src, BitMask& dst);
+    /*! \brief Thresholds the foreground pixels of the input image using the skin lookup table
      *
      *  \param src Input image
-     *  \param dst Binary output image
+     *  \param foreground Pixels to threshold, the rest are not skin
+     *  \param dst Bit-packed output mask
+     */
+	void threshold( const cv::Mat& src, const BitMask& foreground, BitMask& dst);
+    /*! \brief Removes the blobs that are too small to be a hand, and finds the largest one
+     *
+     *  \param src Bit-packed input mask
+     *  \param dst Binary output image (the only byte-per-pixel mask of the pipeline)
+     *  \param offset Position of src in the frame, for the hand box
      */
-	void filterBlobs( const cv::Mat& src, cv::Mat& dst);
+	void filterBlobs( const BitMask& src, cv::Mat& dst, const cv::Point& offset = cv::Point() );
+
+    //! \brief Labels of the blobs of the thresholded image
+    cv::Mat blobLabels;
+
+    //! \brief Statistics of the blobs of the thresholded image
+    std::vector< BlobStats > blobs;
+
+    //! \brief Scratch memory for the blob labelling
+    BlobLabellingBuffers blobBuffers;
+
+    //! \brief Bounding box of the largest blob found on the last frame
+    cv::Rect hand_box;
+
+    //! \brief Bounding boxes of the largest blobs found on the last frame, largest first
+    std::vector<cv::Rect> hand_boxes;
+
+    //! \brief Indices of the largest blobs, kept to avoid allocations
+    std::vector<int> hand_blobs;
+
+    //! \brief Max. number of hand candidates
+    int max_hands;
+
+    //! \brief Temporal vote over the last skin masks
+    MaskFusion maskFusion;
 
-	//-- Filter contours:
-	void filterContours( std::vector< std::vector < cv::Point > >& contours , std::vector< std::vector < cv::Point > >& filteredContours);
+    //! \brief True if the temporal vote is enabled
+    bool mask_fusion;
+
+    //! \brief Min. number of pixels of the blobs kept
+    int min_blob_area;
+
+    /*! \brief Update the segmented hand image processing only a window of the frame
+     *
+     *  \param src Original image coming from the video input.
+     *  \param dst Final binary image containing the segmented image (zero outside the window).
+     *  \param window Region of src to process.
+     */
+    void filterHandInWindow( cv::Mat& src, cv::Mat& dst, const cv::Rect& window );
 
     //-- Background substractor:
     //---------------------------------------------------------------------------------
-    //! \brief Background Subtractor object that derives from cv::BackgroundSubtractorMOG2
-    backgroundSubstractor bg ;
-    //! \brief Sets the parameters of the background subtractor object
+    //! \brief Background model in use
+    BackgroundModel * backgroundModel;
+    //! \brief Type of the background model in use (see constants)
+    unsigned int background_model_type;
+    //! \brief Creates the default background model
     void initBackgroundSubstractor();
-    /*! \brief Substracts the background from the input image
+    //! \brief Frames left to check a restored background (0 if not checking)
+    int background_check_frames;
+    //! \brief Accumulated fraction of foreground during the check of a restored background
+    double background_check_foreground;
+    /*! \brief Runs the background model on the input image, and finds its foreground
      *
-     *  \param src Input image
-     *  \param dst Output image
+     *  \param src Input image (not modified)
+     *  \param dst Full resolution foreground mask
      */
-    void backgroundSubstraction(cv::Mat& src, cv::Mat& dst);
+    void backgroundSubstraction(cv::Mat& src, BitMask& dst);
+    //! \brief Checks a restored background with the foreground it finds, and discards it if it is stale
+    void checkRestoredBackground( const cv::Mat& foreground );
+
+    //! \brief Pyramid level where the background model runs
+    unsigned int background_level;
+
+
+    //-- Workspace:
+    //----------------------------------------------------------------------------------
+    //! \brief Intermediate images of filter_hand, kept between frames so that nothing is allocated
+    struct Workspace
+    {
+        cv::Mat foreground;         //!< \brief Foreground mask at the level of the background model
+        cv::Mat foregroundFull;     //!< \brief Foreground mask at full resolution
+        BitMask foregroundBits;     //!< \brief Foreground mask, bit-packed (of the window size in tracking mode)
+        BitMask thresholded;        //!< \brief Skin mask, before blob filtering (of the window size in tracking mode)
+        BitMask fused;              //!< \brief Full size skin mask for the temporal vote (tracking mode)
+        cv::Mat difference;         //!< \brief Difference with the background image (tracking mode)
+        cv::Mat differenceGrey;     //!< \brief Same, in grey and then thresholded (tracking mode)
+        cv::Mat matchResult;        //!< \brief Template matching scores, for face tracking
+    };
+
+    //! \brief Buffers reused by all the stages
+    Workspace workspace;
+
+
+    //-- Motion gate:
+    //----------------------------------------------------------------------------------
+    //! \brief Returns true if the frame in the pyramid has not changed since the last frame processed
+    bool isStaticFrame( const cv::Mat& src );
+
+    //! \brief Quarter resolution greyscale version of the last frame processed
+    cv::Mat motionReference;
+
+    //! \brief Generation of the skin lookup table when the last frame was processed
+    int motion_lut_generation;
+
+    //! \brief Mask returned for the last frame processed
+    cv::Mat lastMask;
+
+    //! \brief Min. fraction of changed pixels between frames to process them (0 disables the gate)
+    double motion_threshold;
+
+    //! \brief Min. absolute difference for a pixel to count as changed by the motion gate
+    int motion_pixel_threshold;
+
+    //! \brief Buffer for the difference with motionReference
+    cv::Mat motionDifference;
+
+    //! \brief Whether the last frame was skipped
+    bool frame_skipped;
+
+    //! \brief Number of frames skipped / processed
+    long skipped_frames, processed_frames;
+
+
+    //-- Frame pyramid:
+    //----------------------------------------------------------------------------------
+    //! \brief Scaled and greyscale versions of the current frame, shared by all the stages
+    FramePyramid pyramid;
+
+    //! \brief Format of the input frames
+    unsigned int frame_format;
+
+
+    //-- Tracking mode:
+    //----------------------------------------------------------------------------------
+    //! \brief Window where the hand is searched for (empty for full-frame search)
+    cv::Rect search_window;
+
+    //! \brief Background image used while tracking, taken from the background model on the last full-frame search
+    cv::Mat backgroundImage;
+
+    //! \brief True if backgroundImage is up to date with the background model
+    bool background_cached;
+
+    //! \brief Max. number of consecutive frames searched only inside the window
+    int full_frame_interval;
+
+    //! \brief Number of frames searched inside the window since the last full-frame search
+    int window_frames;
+
+    //! \brief Min. grey level difference with the background image to be foreground inside the window
+    int window_background_threshold;
 
 
 	//-- Filter face:
@@ -183,13 +577,110 @@ public:
 	//! -- \brief Initializes the face detector
 	void initCascadeClassifier();
 
-	//! -- \brief Removes the face from the src image
-	void filterFace(const cv::Mat& src, cv::Mat& dstMask );
+	//! -- \brief Finds the faces on the current frame (of the pyramid), and stores them in lastFacesPos
+	void filterFace();
+
+	//! -- \brief Clears the last faces found from a mask whose origin is at offset in the frame
+	void maskFaces( BitMask& mask, const cv::Point& offset = cv::Point() );
+
+	//! -- \brief Runs the cascade classifier on the small grey image and stores the faces and their templates
+	void detectFaces( const cv::Mat& srcGreySmall );
+
+	//! -- \brief Follows the stored faces with template matching. Returns false if any face is lost
+	bool trackFaces( const cv::Mat& srcGreySmall );
+
+	//! -- \brief Faces being tracked, in the coordinates of the small grey image
+	std::vector< cv::Rect > facesSmall;
+
+	//! -- \brief Appearance of each face when it was detected, for tracking
+	std::vector< cv::Mat > faceTemplates;
+
+	//! -- \brief Number of frames between two runs of the cascade classifier
+	int face_detection_period;
+
+	//! -- \brief Frames elapsed since the last run of the cascade classifier
+	int frames_since_detection;
+
+	//! -- \brief Minimum normalized correlation for a face to be considered tracked
+	double face_tracking_threshold;
+
+	//! -- \brief Stores the appearance of the faces found on the small grey image, for tracking
+	void storeFaceTemplates( const cv::Mat& srcGreySmall );
+
+	//! -- \brief Detector thread, NULL if faces are detected synchronously
+	FaceDetectorWorker * faceWorker;
+
+	//! -- \brief Number of frames processed by filterFace
+	long frame_count;
+
+	//! -- \brief Number of the frame where the current faces were detected
+	long faces_frame;
 
 
 
 	//-- Skin hue calibration
 	//-----------------------------------------------------------------------------------
+	//! \brief Lookup table used to threshold the skin, built from the HSV limits
+	SkinLUT skinLUT;
+
+	//! \brief Rebuilds the skin lookup table if the skin model or its parameters have changed
+	void updateSkinLUT();
+
+	//! \brief Skin model used for thresholding
+	unsigned int skin_model;
+
+	//! \brief Hue-Saturation histogram of the user's skin, learnt on calibration with a ROI
+	SkinHistogram skinHistogram;
+
+	//! \brief Minimum likelihood for a color to be skin with the histogram model
+	int likelihood_cutoff;
+
+	//! \brief Lower limits of the box models, by color space (HSV uses lower_limit)
+	cv::Scalar box_lower[ GECKO_COLOR_SPACES ];
+	//! \brief Upper limits of the box models, by color space (HSV uses upper_limit)
+	cv::Scalar box_upper[ GECKO_COLOR_SPACES ];
+
+	//! \brief Returns the color space of a box skin model, or GECKO_COLOR_SPACES if it is not a box
+	static unsigned int boxColorSpace( unsigned int skin_model );
+
+	//-- Skin adaptation
+	//! \brief True if the skin histogram adapts to the lighting
+	bool skin_adaptation;
+	//! \brief Seconds between two updates of the skin histogram
+	double skin_adaptation_period;
+	//! \brief Weight of the new samples in each update
+	double skin_adaptation_rate;
+	//! \brief Min. similarity of an updated model with the calibrated one
+	double skin_min_similarity;
+	//! \brief Time of the last update of the skin histogram, in seconds
+	double last_skin_adaptation;
+	//! \brief Mask of the hand being sampled
+	cv::Mat adaptationMask;
+	//! \brief Normalized pixels of the hand being sampled
+	cv::Mat adaptationFrame;
+	//! \brief Running mean of the fraction of the frame found to be skin, before the last update
+	double skin_fraction_reference;
+	//! \brief Frames left to check the last update (0 if not checking)
+	int skin_check_frames;
+	//! \brief Accumulated fraction of skin during the check of the last update
+	double skin_check_fraction;
+
+	//! \brief Tracks the amount of skin found, and rolls back an update of the model after which it grows too much
+	void checkSkinAdaptation( const BitMask& skin );
+
+	//-- Illumination normalization
+	//! \brief True if the frames are normalized to the lighting of the calibration
+	bool illumination_normalization;
+	//! \brief Mean color of the scene on calibration
+	cv::Scalar illumination_reference;
+	//! \brief False until the reference is taken
+	bool illumination_reference_valid;
+	//! \brief Smoothed gains of each channel, applied by the skin lookup table
+	cv::Scalar illumination_gains;
+
+	//! \brief Estimates the channel gains of the current frame and passes them to the skin lookup table
+	void updateIlluminationGains();
+
 	//-- HSV limits
     //! \brief Lower limit of the HSV skin range
 	cv::Scalar lower_limit;
@@ -209,6 +700,9 @@ public:
     //! \brief Size of the calibration box used when capturing the custom HSV range
     static const int halfSide=40;
 
+    //! \brief Number of frames of the calibration box used to capture the custom HSV range
+    int calibration_frames;
+
     //! \brief Lower limit of the HSV skin range
     cv::Scalar lower;
     //! \brief Upper limit of the HSV skin range
@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+//-- HandsManager
+//------------------------------------------------------------------------------
+//--
+//-- Tracks several hands, each one with its own HandDescriptor
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file HandsManager.cpp
+ *  \brief Tracks several hands, each one with its own HandDescriptor
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "HandsManager.h"
+#include <algorithm>
+
+
+HandsManager::HandsManager(int max_hands, int max_missed_frames)
+{
+    this->max_hands = std::max( max_hands, 1 );
+    this->max_missed_frames = max_missed_frames;
+    next_id = 0;
+    mirrored = false;
+}
+
+HandsManager::~HandsManager()
+{
+    for ( int i = 0; i < (int) tracked.size(); i++ )
+        delete tracked[i];
+}
+
+void HandsManager::operator()(const cv::Mat &skinMask, const std::vector<cv::Rect> &handBoxes)
+{
+    update( skinMask, handBoxes );
+}
+
+void HandsManager::update(const cv::Mat &skinMask, const std::vector<cv::Rect> &handBoxes)
+{
+    //-- Pair the candidates with the hands already tracked:
+    //---------------------------------------------------------------------------
+    associate( handBoxes, skinMask.size() );
+
+    //-- The rest of candidates are new hands, if there is room for them:
+    for ( int i = 0; i < (int) handBoxes.size() && (int) tracked.size() < max_hands; i++ )
+        if ( !candidate_used[i] )
+        {
+            TrackedHand * hand = new TrackedHand;
+            hand->id = next_id++;
+            hand->missed_frames = 0;
+            hand->descriptor.setMirrored( mirrored );
+
+            tracked.push_back( hand );
+            tracked_candidate.push_back( i );
+        }
+
+    //-- Collect the hands seen, and drop the ones lost for too long:
+    //---------------------------------------------------------------------------
+    visible.clear();
+    int kept = 0;
+    for ( int i = 0; i < (int) tracked.size(); i++ )
+    {
+        TrackedHand * hand = tracked[i];
+
+        if ( tracked_candidate[i] >= 0 )
+        {
+            hand->box = handBoxes[ tracked_candidate[i] ];
+            hand->missed_frames = 0;
+            visible.push_back( hand );
+        }
+        else if ( ++hand->missed_frames > max_missed_frames )
+        {
+            delete hand;
+            continue;
+        }
+
+        tracked[kept++] = hand;
+    }
+    tracked.resize( kept );
+
+    //-- Describe the hands seen, one per core:
+    //---------------------------------------------------------------------------
+    cv::parallel_for_( cv::Range( 0, visible.size() ), DescribeHands( skinMask, visible ) );
+
+    //-- Candidates in which no hand contour was found are not hands:
+    kept = 0;
+    for ( int i = 0; i < (int) visible.size(); i++ )
+        if ( visible[i]->descriptor.handFound() )
+            visible[kept++] = visible[i];
+    visible.resize( kept );
+}
+
+int HandsManager::getNumHands()
+{
+    return visible.size();
+}
+
+HandDescriptor &HandsManager::getHand(int i)
+{
+    return visible[i]->descriptor;
+}
+
+int HandsManager::getHandId(int i)
+{
+    return visible[i]->id;
+}
+
+int HandsManager::getPrimaryHand()
+{
+    //-- Identifiers grow with each new hand, so the lowest one is the oldest:
+    int primary = -1;
+    for ( int i = 0; i < (int) visible.size(); i++ )
+        if ( primary < 0 || visible[i]->id < visible[primary]->id )
+            primary = i;
+
+    return primary;
+}
+
+cv::Rect HandsManager::getSearchWindow(const cv::Size &frame_size, float margin)
+{
+    //-- A new hand may appear anywhere:
+    if ( (int) tracked.size() < max_hands )
+        return cv::Rect();
+
+    cv::Rect window;
+    for ( int i = 0; i < (int) tracked.size(); i++ )
+    {
+        cv::Rect hand_window = tracked[i]->descriptor.getSearchWindow( frame_size, margin );
+        if ( hand_window.area() == 0 )
+            return cv::Rect();
+
+        window = window.area() == 0 ? hand_window : window | hand_window;
+    }
+
+    return window;
+}
+
+void HandsManager::setMaxHands(int max_hands)
+{
+    this->max_hands = std::max( max_hands, 1 );
+}
+
+int HandsManager::getMaxHands()
+{
+    return max_hands;
+}
+
+void HandsManager::setMirrored(bool mirrored)
+{
+    this->mirrored = mirrored;
+
+    for ( int i = 0; i < (int) tracked.size(); i++ )
+        tracked[i]->descriptor.setMirrored( mirrored );
+}
+
+void HandsManager::plotHandInterface(cv::Mat &src, cv::Mat &dst)
+{
+    if ( dst.empty() )
+        dst = src.clone();
+
+    for ( int i = 0; i < (int) visible.size(); i++ )
+    {
+        visible[i]->descriptor.plotHandInterface( dst, dst );
+
+        std::stringstream ss;
+        ss << "#" << visible[i]->id;
+
+        //-- At the center of the hand, which is mirrored with the rest of the plots:
+        cv::putText( dst, ss.str(), visible[i]->descriptor.getCenterHand(),
+                     cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar( 0, 255, 255 ) );
+    }
+}
+
+void HandsManager::associate(const std::vector<cv::Rect> &handBoxes, const cv::Size &frame_size)
+{
+    tracked_candidate.assign( tracked.size(), -1 );
+    candidate_used.assign( handBoxes.size(), false );
+
+    //-- Distance from each candidate to the predicted position of each hand, if inside its window:
+    std::vector< std::pair< double, std::pair<int, int> > > pairs;
+    for ( int i = 0; i < (int) tracked.size(); i++ )
+    {
+        cv::Rect window = tracked[i]->descriptor.getSearchWindow( frame_size );
+        if ( window.area() == 0 )
+            window = tracked[i]->box;
+
+        cv::Point predicted( window.x + window.width / 2, window.y + window.height / 2 );
+
+        for ( int j = 0; j < (int) handBoxes.size(); j++ )
+        {
+            cv::Point center( handBoxes[j].x + handBoxes[j].width / 2, handBoxes[j].y + handBoxes[j].height / 2 );
+            if ( window.contains( center ) )
+                pairs.push_back( std::make_pair( cv::norm( center - predicted ), std::make_pair( i, j ) ) );
+        }
+    }
+
+    //-- Greedy assignment, closest pairs first (there are just a few hands):
+    std::sort( pairs.begin(), pairs.end() );
+    for ( int k = 0; k < (int) pairs.size(); k++ )
+    {
+        int hand = pairs[k].second.first;
+        int candidate = pairs[k].second.second;
+
+        if ( tracked_candidate[hand] < 0 && !candidate_used[candidate] )
+        {
+            tracked_candidate[hand] = candidate;
+            candidate_used[candidate] = true;
+        }
+    }
+}
+
+HandsManager::DescribeHands::DescribeHands(const cv::Mat &skinMask, const std::vector<TrackedHand *> &hands)
+    : skinMask( skinMask ), hands( hands )
+{
+}
+
+void HandsManager::DescribeHands::operator()(const cv::Range &range) const
+{
+    //-- Each descriptor only writes to its own state:
+    for ( int i = range.start; i < range.end; i++ )
+        hands[i]->descriptor.update( skinMask, hands[i]->box );
+}
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+//-- HandsManager
+//------------------------------------------------------------------------------
+//--
+//-- Tracks several hands, each one with its own HandDescriptor
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file HandsManager.h
+ *  \brief Tracks several hands, each one with its own HandDescriptor
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef HANDS_MANAGER_H
+#define HANDS_MANAGER_H
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "HandDescriptor.h"
+
+
+/*! \class HandsManager
+ *  \brief Tracks several hands, each one with its own HandDescriptor
+ *
+ *  Each tracked hand owns a HandDescriptor, and therefore its own Kalman filters. On every frame, the
+ *  hand candidates (e.g. HandDetector::getHandBoxes()) are associated to the tracked hands by distance
+ *  to their predicted position; candidates left unmatched start new hands, and hands without a
+ *  candidate for some frames are dropped. The descriptors of the hands seen are updated in parallel.
+ */
+class HandsManager
+{
+    public:
+        /*! \brief Constructor
+         *  \param max_hands Max. number of hands tracked at the same time
+         *  \param max_missed_frames Frames a hand is kept without being seen, to recover it if it appears again
+         */
+        HandsManager( int max_hands = 2, int max_missed_frames = 5 );
+
+        //! \brief Destructor
+        ~HandsManager();
+
+        //! \brief Wrapper of update()
+        void operator()( const cv::Mat& skinMask, const std::vector<cv::Rect>& handBoxes );
+
+        /*! \brief Associates the candidates to the tracked hands, and updates their descriptors
+         *  \param skinMask Binary image containing the skin zones of the hand candidates
+         *  \param handBoxes Bounding boxes of the hand candidates, largest first
+         */
+        void update( const cv::Mat& skinMask, const std::vector<cv::Rect>& handBoxes );
+
+        //! \brief Returns the number of hands found on the last frame
+        int getNumHands();
+
+        //! \brief Returns the descriptor of the i-th hand found on the last frame
+        HandDescriptor& getHand( int i );
+
+        //! \brief Returns an identifier of the i-th hand found on the last frame, that does not change while it is tracked
+        int getHandId( int i );
+
+        //! \brief Returns the index of the hand found on the last frame that has been tracked for longest (-1 if none)
+        int getPrimaryHand();
+
+        /*! \brief Returns the window where the hands are expected on the next frame
+         *
+         *  It is the bounding box of the search windows of all the tracked hands, or empty if there are
+         *  none (so that the whole frame is searched).
+         */
+        cv::Rect getSearchWindow( const cv::Size& frame_size, float margin = 0.5 );
+
+        //! \brief Sets the max. number of hands tracked at the same time
+        void setMaxHands( int max_hands );
+
+        //! \brief Returns the max. number of hands tracked at the same time
+        int getMaxHands();
+
+        //! \brief Mirrors the outputs of every hand (see HandDescriptor::setMirrored())
+        void setMirrored( bool mirrored );
+
+        //! \brief Plots the interface of every hand found on display
+        void plotHandInterface( cv::Mat& src, cv::Mat& dst );
+
+    private:
+        //! \brief A hand being tracked
+        struct TrackedHand
+        {
+            HandDescriptor descriptor;  //!< \brief Hand characteristics and Kalman filters
+            int id;                     //!< \brief Identifier of the hand
+            int missed_frames;          //!< \brief Consecutive frames without a candidate
+            cv::Rect box;               //!< \brief Candidate associated on the last frame
+        };
+
+        //! \brief Updates the descriptors of a set of hands, to run them in parallel
+        class DescribeHands : public cv::ParallelLoopBody
+        {
+            public:
+                DescribeHands( const cv::Mat& skinMask, const std::vector<TrackedHand*>& hands );
+                void operator()( const cv::Range& range ) const;
+
+            private:
+                const cv::Mat& skinMask;
+                const std::vector<TrackedHand*>& hands;
+        };
+
+        //! \brief Pairs candidates and hands, closest first, as long as the candidate is inside the hand search window
+        void associate( const std::vector<cv::Rect>& handBoxes, const cv::Size& frame_size );
+
+        //! \brief Tracked hands, seen or not on the last frame
+        std::vector<TrackedHand*> tracked;
+
+        //! \brief Hands seen on the last frame
+        std::vector<TrackedHand*> visible;
+
+        //! \brief Candidate associated to each tracked hand (-1 if none)
+        std::vector<int> tracked_candidate;
+
+        //! \brief Whether each candidate has been associated
+        std::vector<bool> candidate_used;
+
+        int max_hands;          //!< \brief Max. number of hands tracked
+        int max_missed_frames;  //!< \brief Frames a hand is kept without being seen
+        int next_id;            //!< \brief Identifier of the next new hand
+        bool mirrored;          //!< \brief Whether the outputs of the hands are mirrored
+
+        //-- Tracked hands are owned, so copies are not allowed:
+        HandsManager( const HandsManager& );
+        HandsManager& operator=( const HandsManager& );
+};
+
+#endif // HANDS_MANAGER_H
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+//-- MOG2BackgroundModel
+//------------------------------------------------------------------------------
+//--
+//-- Background model based on a Mixture Of Gaussians
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file MOG2BackgroundModel.cpp
+ *  \brief Background model based on a Mixture Of Gaussians
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "MOG2BackgroundModel.h"
+#include <fstream>
+
+static const char MOG2_TAG[] = "MOG2";
+
+MOG2BackgroundModel::MOG2BackgroundModel()
+{
+    bg.set("nmixtures",3);// set number of gaussian mixtures
+    bg.set("detectShadows", true); //if false: turn shadow detection off
+    bg.setbackgroundRatio(0.000000000000001);
+}
+
+void MOG2BackgroundModel::apply(const cv::Mat &frame, cv::Mat &foreground)
+{
+    bg( frame, foreground );
+}
+
+void MOG2BackgroundModel::getBackgroundImage(cv::Mat &background)
+{
+    bg.getBackgroundImage( background );
+}
+
+bool MOG2BackgroundModel::save(const std::string &file)
+{
+    std::ofstream out( file.c_str(), std::ios::binary );
+    if ( !out )
+        return false;
+
+    cv::Size size = bg.getFrameSize();
+    int header[5] = { bg.getMixtures(), size.width, size.height, bg.getFrameType(), bg.getFrames() };
+
+    writeTag( out, MOG2_TAG );
+    out.write( (const char *) header, sizeof(header) );
+    writeMat( out, bg.getModel() );
+    writeMat( out, bg.getUsedModes() );
+
+    return out.good();
+}
+
+bool MOG2BackgroundModel::load(const std::string &file)
+{
+    std::ifstream in( file.c_str(), std::ios::binary );
+    if ( !in || !readTag( in, MOG2_TAG ) )
+        return false;
+
+    int header[5];
+    cv::Mat model, usedModes;
+    if ( !in.read( (char *) header, sizeof(header) ) || !readMat( in, model, CV_32FC1 ) || !readMat( in, usedModes, CV_8UC1 ) )
+        return false;
+
+    //-- The model layout depends on the number of mixtures, the number of channels and the frame size:
+    cv::Size size( header[1], header[2] );
+    size_t model_size = (size_t) size.area() * header[0] * ( 2 + CV_MAT_CN( header[3] ) );
+
+    if ( header[0] != bg.getMixtures() || usedModes.size() != size || model.total() != model_size )
+        return false;
+
+    bg.setState( size, header[3], header[4], model, usedModes );
+    return true;
+}
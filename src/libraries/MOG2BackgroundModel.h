@@ -0,0 +1,55 @@
+//------------------------------------------------------------------------------
+//-- MOG2BackgroundModel
+//------------------------------------------------------------------------------
+//--
+//-- Background model based on a Mixture Of Gaussians
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file MOG2BackgroundModel.h
+ *  \brief Background model based on a Mixture Of Gaussians
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef MOG2BACKGROUNDMODEL_H
+#define MOG2BACKGROUNDMODEL_H
+
+#include "BackgroundModel.h"
+#include "backgroundSubstractor.h"
+
+
+/*! \class MOG2BackgroundModel
+ *  \brief Background model based on a Mixture Of Gaussians (cv::BackgroundSubtractorMOG2)
+ *
+ *  Robust to multimodal backgrounds and able to detect shadows, but several float operations
+ *  per pixel and mixture.
+ */
+class MOG2BackgroundModel : public BackgroundModel
+{
+    public:
+        //! \brief Creates the model with 3 mixtures and shadow detection
+        MOG2BackgroundModel();
+
+        void apply( const cv::Mat& frame, cv::Mat& foreground );
+        void getBackgroundImage( cv::Mat& background );
+        bool save( const std::string& file );
+        bool load( const std::string& file );
+
+    private:
+        //! \brief Background Subtractor object that derives from cv::BackgroundSubtractorMOG2
+        backgroundSubstractor bg;
+};
+
+#endif // MOG2BACKGROUNDMODEL_H
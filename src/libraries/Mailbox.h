@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+//-- Mailbox
+//------------------------------------------------------------------------------
+//--
+//-- Lock-free single producer / single consumer mailbox
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file Mailbox.h
+ *  \brief Lock-free single producer / single consumer mailbox
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+/*! \class Mailbox
+ *  \brief Passes the newest message from one thread to another without locks
+ *
+ *  It is a triple buffer: the producer owns one slot, the consumer owns another one, and the third one
+ *  is exchanged atomically between them. Messages that are not fetched in time are overwritten by newer
+ *  ones, so neither side ever waits. Slots are reused, so messages holding buffers (e.g. cv::Mat) do not
+ *  allocate once they reach their final size.
+ */
+template <class T>
+class Mailbox
+{
+    public:
+        Mailbox() : back(0), middle(1), front(2) {}
+
+        //! \brief Returns the slot where the producer prepares the next message
+        T& writeSlot() { return slots[back]; }
+
+        //! \brief Publishes the message prepared in writeSlot(), replacing any message not fetched yet
+        void publish()
+        {
+            __sync_synchronize();
+            back = __sync_lock_test_and_set( &middle, back | FRESH ) & INDEX;
+        }
+
+        /*! \brief Takes the newest published message
+         *  \return False if nothing was published since the last fetch
+         */
+        bool fetch()
+        {
+            if ( !( middle & FRESH ) )
+                return false;
+
+            front = __sync_lock_test_and_set( &middle, front ) & INDEX;
+            __sync_synchronize();
+            return true;
+        }
+
+        //! \brief Returns the last message fetched (valid until the next fetch)
+        T& readSlot() { return slots[front]; }
+
+    private:
+        static const int FRESH = 4;     //!< \brief Flag set on the shared slot index when it holds a new message
+        static const int INDEX = 3;     //!< \brief Mask for the slot index
+
+        T slots[3];                     //!< \brief Message storage
+        int back;                       //!< \brief Slot owned by the producer
+        volatile int middle;            //!< \brief Slot being exchanged (and FRESH flag)
+        int front;                      //!< \brief Slot owned by the consumer
+};
+
+#endif // MAILBOX_H
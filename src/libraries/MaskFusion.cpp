@@ -0,0 +1,131 @@
+//------------------------------------------------------------------------------
+//-- MaskFusion
+//------------------------------------------------------------------------------
+//--
+//-- Temporal k-of-n vote over the last binary masks
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file MaskFusion.cpp
+ *  \brief Temporal k-of-n vote over the last binary masks
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "MaskFusion.h"
+#include <algorithm>
+
+MaskFusion::MaskFusion(int length, int votes)
+{
+    setVote( length, votes );
+}
+
+void MaskFusion::setVote(int length, int votes)
+{
+    this->length = std::min( std::max( length, 1 ), (int) MAX_LENGTH );
+    this->votes = std::min( std::max( votes, 1 ), this->length );
+
+    num_planes = 1;
+    while ( ( 1 << num_planes ) <= this->length )
+        num_planes++;
+
+    ring.assign( this->length, BitMask() );
+    planes.assign( num_planes, std::vector<uint64_t>() );
+    reset();
+}
+
+int MaskFusion::getLength() const
+{
+    return length;
+}
+
+int MaskFusion::getVotes() const
+{
+    return votes;
+}
+
+void MaskFusion::reset()
+{
+    filled = 0;
+    next = 0;
+}
+
+void MaskFusion::apply(BitMask &mask)
+{
+    const int words = mask.getRows() * mask.getWordsPerRow();
+    if ( words == 0 )
+        return;
+
+    //-- Start again on a size change:
+    if ( filled > 0 && ( ring[0].getRows() != mask.getRows() || ring[0].getCols() != mask.getCols() ) )
+        reset();
+
+    if ( filled == 0 )
+        for ( int p = 0; p < num_planes; p++ )
+            planes[p].assign( words, 0 );
+
+    //-- Keep the new mask, evicting the oldest one:
+    BitMask& slot = ring[next];
+    bool evict = filled == length;
+
+    if ( !evict )
+        slot.create( mask.getRows(), mask.getCols() );
+
+    const uint64_t * in = mask.row( 0 );
+    uint64_t * old = slot.row( 0 );
+    uint64_t * out = mask.row( 0 );
+
+    //-- Comparison of the counts with the threshold, MSB first:
+    int threshold = std::min( votes, filled + ( evict ? 0 : 1 ) );
+
+    for ( int w = 0; w < words; w++ )
+    {
+        uint64_t added = in[w];
+        uint64_t removed = evict ? old[w] : 0;
+        old[w] = added;
+
+        //-- Only the pixels that change their count are updated:
+        uint64_t carry = added & ~removed;
+        uint64_t borrow = removed & ~added;
+
+        for ( int p = 0; p < num_planes && ( carry | borrow ); p++ )
+        {
+            uint64_t plane = planes[p][w];
+            uint64_t next_carry = plane & carry;
+            uint64_t next_borrow = ~plane & borrow;
+            planes[p][w] = plane ^ carry ^ borrow;
+            carry = next_carry;
+            borrow = next_borrow;
+        }
+
+        //-- count >= threshold:
+        uint64_t greater = 0, equal = ~(uint64_t) 0;
+        for ( int p = num_planes - 1; p >= 0; p-- )
+        {
+            uint64_t plane = planes[p][w];
+            if ( ( threshold >> p ) & 1 )
+                equal &= plane;
+            else
+            {
+                greater |= equal & plane;
+                equal &= ~plane;
+            }
+        }
+
+        out[w] = greater | equal;
+    }
+
+    next = ( next + 1 ) % length;
+    filled = std::min( filled + 1, length );
+}
@@ -0,0 +1,86 @@
+//------------------------------------------------------------------------------
+//-- MaskFusion
+//------------------------------------------------------------------------------
+//--
+//-- Temporal k-of-n vote over the last binary masks
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file MaskFusion.h
+ *  \brief Temporal k-of-n vote over the last binary masks
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef MASKFUSION_H
+#define MASKFUSION_H
+
+#include <vector>
+#include <stdint.h>
+#include <opencv2/opencv.hpp>
+#include "BitMask.h"
+
+
+/*! \class MaskFusion
+ *  \brief Temporal k-of-n vote over the last binary masks
+ *
+ *  A pixel of the fused mask is set if it was set in at least k of the last n masks, which removes
+ *  the noise that flickers from frame to frame while keeping the hand. The last n masks are kept in
+ *  a ring, and the vote of each pixel is a running count: the new mask is added and the evicted one
+ *  subtracted. Counts are bit-sliced (bit p of the counts of 64 pixels lives in one word of plane p),
+ *  so adding, subtracting and comparing with k are a few word operations per 64 pixels, whatever n is.
+ */
+class MaskFusion
+{
+    public:
+        //! \brief Max. number of masks in the vote
+        static const int MAX_LENGTH = 31;
+
+        /*! \brief Constructor
+         *  \param length Number of masks in the vote, n (1 to MAX_LENGTH)
+         *  \param votes Min. number of masks in which a pixel must be set, k (1 to n)
+         */
+        MaskFusion( int length = 3, int votes = 2 );
+
+        //! \brief Changes the vote, and starts again
+        void setVote( int length, int votes );
+
+        //! \brief Returns the number of masks in the vote
+        int getLength() const;
+
+        //! \brief Returns the min. number of masks in which a pixel must be set
+        int getVotes() const;
+
+        //! \brief Forgets the previous masks
+        void reset();
+
+        /*! \brief Adds a new mask to the vote, and replaces it with the fused mask
+         *
+         *  Until n masks have been seen, the vote is k out of the masks available (at most). A mask of
+         *  a different size restarts the vote.
+         */
+        void apply( BitMask& mask );
+
+    private:
+        int length;                         //!< \brief Number of masks in the vote
+        int votes;                          //!< \brief Min. number of votes for a pixel to be set
+        int num_planes;                     //!< \brief Bits of the counts
+        int filled;                         //!< \brief Number of masks in the ring
+        int next;                           //!< \brief Slot of the ring for the next mask
+
+        std::vector<BitMask> ring;          //!< \brief Last masks
+        std::vector< std::vector<uint64_t> > planes;  //!< \brief Bit-sliced vote counts, least significant bit first
+};
+
+#endif // MASKFUSION_H
@@ -0,0 +1,69 @@
+//------------------------------------------------------------------------------
+//-- RawYUVFileSource
+//------------------------------------------------------------------------------
+//--
+//-- Frame source that reads raw YUYV or NV12 frames from a file
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file RawYUVFileSource.cpp
+ *  \brief Frame source that reads raw YUYV or NV12 frames from a file
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "RawYUVFileSource.h"
+#include <iostream>
+
+RawYUVFileSource::RawYUVFileSource(const std::string &file, const cv::Size &size, unsigned int format)
+{
+    this->size = size;
+    this->format = format;
+
+    if ( size.width <= 0 || size.height <= 0 || size.width % 2 || size.height % 2
+         || ( format != FramePyramid::GECKO_FORMAT_YUYV && format != FramePyramid::GECKO_FORMAT_NV12 ) )
+    {
+        std::cerr << "[Error] Raw YUV frames must be YUYV or NV12, with an even size" << std::endl;
+        return;
+    }
+
+    this->file.open( file.c_str(), std::ios::binary );
+}
+
+bool RawYUVFileSource::isOpened()
+{
+    return file.is_open();
+}
+
+bool RawYUVFileSource::read(cv::Mat &frame)
+{
+    if ( !file.is_open() )
+        return false;
+
+    if ( format == FramePyramid::GECKO_FORMAT_YUYV )
+        buffer.create( size, CV_8UC2 );
+    else
+        buffer.create( size.height * 3 / 2, size.width, CV_8UC1 );
+
+    if ( !file.read( (char *) buffer.data, buffer.total() * buffer.elemSize() ) )
+        return false;
+
+    frame = buffer;
+    return true;
+}
+
+unsigned int RawYUVFileSource::getFormat()
+{
+    return format;
+}
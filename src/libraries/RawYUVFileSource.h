@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+//-- RawYUVFileSource
+//------------------------------------------------------------------------------
+//--
+//-- Frame source that reads raw YUYV or NV12 frames from a file
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file RawYUVFileSource.h
+ *  \brief Frame source that reads raw YUYV or NV12 frames from a file
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef RAWYUVFILESOURCE_H
+#define RAWYUVFILESOURCE_H
+
+#include <string>
+#include <fstream>
+#include "FrameSource.h"
+
+
+/*! \class RawYUVFileSource
+ *  \brief Frame source that reads raw YUYV or NV12 frames from a file
+ *
+ *  The file is just the frames one after the other, with no header (as written by e.g.
+ *  `ffmpeg -pix_fmt yuyv422 -f rawvideo`), so the size and format must be given. Used to run the YUV
+ *  path of the detector on recorded sequences.
+ */
+class RawYUVFileSource : public FrameSource
+{
+    public:
+        /*! \brief Opens the file
+         *  \param file Path of the file
+         *  \param size Size of the frames, in pixels (even width and height)
+         *  \param format FramePyramid::GECKO_FORMAT_YUYV or FramePyramid::GECKO_FORMAT_NV12
+         */
+        RawYUVFileSource( const std::string& file, const cv::Size& size, unsigned int format );
+
+        bool isOpened();
+        bool read( cv::Mat& frame );
+        unsigned int getFormat();
+
+    private:
+        std::ifstream file;     //!< \brief File the frames are read from
+        cv::Size size;          //!< \brief Size of the frames, in pixels
+        unsigned int format;    //!< \brief Format of the frames
+        cv::Mat buffer;         //!< \brief Last frame read
+};
+
+#endif // RAWYUVFILESOURCE_H
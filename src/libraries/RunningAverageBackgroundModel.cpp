@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+//-- RunningAverageBackgroundModel
+//------------------------------------------------------------------------------
+//--
+//-- Background model based on an exponential running average
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file RunningAverageBackgroundModel.cpp
+ *  \brief Background model based on an exponential running average
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "RunningAverageBackgroundModel.h"
+#include <fstream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static const char RUNNING_AVERAGE_TAG[] = "RAVG";
+
+
+//-- Updates one row of the average and flags the channels that differ from it
+//--
+//-- Each element is updated as avg = avg - avg / 2^k + x * 2^(8-k), which is the running average
+//-- with rate 1 / 2^k in 8.8 fixed point, and never overflows 16 bits. The comparison uses the
+//-- average before the update.
+static void updateRow( const uchar * x, ushort * avg, uchar * changed, int n, int shift, int threshold )
+{
+    int i = 0;
+
+#if defined(__AVX2__)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i half = _mm256_set1_epi16( 128 );
+        const __m256i limit = _mm256_set1_epi8( (char) threshold );
+        const __m128i k = _mm_cvtsi32_si128( shift );
+        const __m128i k_in = _mm_cvtsi32_si128( 8 - shift );
+
+        for ( ; i + 32 <= n; i += 32 )
+        {
+            //-- Reorder the quadwords so that the in-lane unpacks give elements 0-15 and 16-31:
+            __m256i pixels = _mm256_permute4x64_epi64( _mm256_loadu_si256( (const __m256i *) ( x + i ) ), 0xD8 );
+            __m256i x_lo = _mm256_unpacklo_epi8( pixels, zero );
+            __m256i x_hi = _mm256_unpackhi_epi8( pixels, zero );
+
+            __m256i avg_lo = _mm256_loadu_si256( (const __m256i *) ( avg + i ) );
+            __m256i avg_hi = _mm256_loadu_si256( (const __m256i *) ( avg + i + 16 ) );
+
+            //-- Background, rounded to 8 bit:
+            __m256i background = _mm256_packus_epi16( _mm256_srli_epi16( _mm256_add_epi16( avg_lo, half ), 8 ),
+                                                      _mm256_srli_epi16( _mm256_add_epi16( avg_hi, half ), 8 ) );
+            background = _mm256_permute4x64_epi64( background, 0xD8 );
+            pixels = _mm256_permute4x64_epi64( pixels, 0xD8 );
+
+            //-- |x - background| > threshold:
+            __m256i difference = _mm256_or_si256( _mm256_subs_epu8( pixels, background ),
+                                                  _mm256_subs_epu8( background, pixels ) );
+            __m256i same = _mm256_cmpeq_epi8( _mm256_subs_epu8( difference, limit ), zero );
+            _mm256_storeu_si256( (__m256i *) ( changed + i ), _mm256_xor_si256( same, _mm256_set1_epi8( -1 ) ) );
+
+            //-- Update:
+            avg_lo = _mm256_add_epi16( _mm256_sub_epi16( avg_lo, _mm256_srl_epi16( avg_lo, k ) ), _mm256_sll_epi16( x_lo, k_in ) );
+            avg_hi = _mm256_add_epi16( _mm256_sub_epi16( avg_hi, _mm256_srl_epi16( avg_hi, k ) ), _mm256_sll_epi16( x_hi, k_in ) );
+            _mm256_storeu_si256( (__m256i *) ( avg + i ), avg_lo );
+            _mm256_storeu_si256( (__m256i *) ( avg + i + 16 ), avg_hi );
+        }
+    }
+#endif
+
+#if defined(__SSE2__)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i half = _mm_set1_epi16( 128 );
+        const __m128i limit = _mm_set1_epi8( (char) threshold );
+        const __m128i k = _mm_cvtsi32_si128( shift );
+        const __m128i k_in = _mm_cvtsi32_si128( 8 - shift );
+
+        for ( ; i + 16 <= n; i += 16 )
+        {
+            __m128i pixels = _mm_loadu_si128( (const __m128i *) ( x + i ) );
+            __m128i x_lo = _mm_unpacklo_epi8( pixels, zero );
+            __m128i x_hi = _mm_unpackhi_epi8( pixels, zero );
+
+            __m128i avg_lo = _mm_loadu_si128( (const __m128i *) ( avg + i ) );
+            __m128i avg_hi = _mm_loadu_si128( (const __m128i *) ( avg + i + 8 ) );
+
+            __m128i background = _mm_packus_epi16( _mm_srli_epi16( _mm_add_epi16( avg_lo, half ), 8 ),
+                                                   _mm_srli_epi16( _mm_add_epi16( avg_hi, half ), 8 ) );
+
+            __m128i difference = _mm_or_si128( _mm_subs_epu8( pixels, background ),
+                                               _mm_subs_epu8( background, pixels ) );
+            __m128i same = _mm_cmpeq_epi8( _mm_subs_epu8( difference, limit ), zero );
+            _mm_storeu_si128( (__m128i *) ( changed + i ), _mm_xor_si128( same, _mm_set1_epi8( -1 ) ) );
+
+            avg_lo = _mm_add_epi16( _mm_sub_epi16( avg_lo, _mm_srl_epi16( avg_lo, k ) ), _mm_sll_epi16( x_lo, k_in ) );
+            avg_hi = _mm_add_epi16( _mm_sub_epi16( avg_hi, _mm_srl_epi16( avg_hi, k ) ), _mm_sll_epi16( x_hi, k_in ) );
+            _mm_storeu_si128( (__m128i *) ( avg + i ), avg_lo );
+            _mm_storeu_si128( (__m128i *) ( avg + i + 8 ), avg_hi );
+        }
+    }
+#endif
+
+    for ( ; i < n; i++ )
+    {
+        int background = ( avg[i] + 128 ) >> 8;
+        int difference = x[i] > background ? x[i] - background : background - x[i];
+        changed[i] = difference > threshold ? 255 : 0;
+
+        avg[i] = avg[i] - ( avg[i] >> shift ) + ( x[i] << ( 8 - shift ) );
+    }
+}
+
+RunningAverageBackgroundModel::RunningAverageBackgroundModel(int learning_shift, int threshold)
+{
+    setLearningShift( learning_shift );
+    setThreshold( threshold );
+}
+
+void RunningAverageBackgroundModel::apply(const cv::Mat &frame, cv::Mat &foreground)
+{
+    CV_Assert( frame.type() == CV_8UC3 );
+
+    //-- Start from the first frame (or restart if the size changes):
+    if ( average.size() != frame.size() )
+        frame.convertTo( average, CV_16UC3, 256 );
+
+    foreground.create( frame.size(), CV_8UC1 );
+    changed.resize( frame.cols * 3 );
+
+    for ( int i = 0; i < frame.rows; i++ )
+    {
+        updateRow( frame.ptr<uchar>( i ), average.ptr<ushort>( i ), &changed[0], frame.cols * 3, learning_shift, threshold );
+
+        //-- A pixel is foreground if any of its channels is:
+        uchar * fore = foreground.ptr<uchar>( i );
+        for ( int j = 0; j < frame.cols; j++ )
+            fore[j] = changed[3*j] | changed[3*j+1] | changed[3*j+2];
+    }
+}
+
+void RunningAverageBackgroundModel::getBackgroundImage(cv::Mat &background)
+{
+    if ( average.empty() )
+        background.release();
+    else
+        average.convertTo( background, CV_8UC3, 1.0 / 256 );
+}
+
+bool RunningAverageBackgroundModel::save(const std::string &file)
+{
+    std::ofstream out( file.c_str(), std::ios::binary );
+    if ( !out )
+        return false;
+
+    writeTag( out, RUNNING_AVERAGE_TAG );
+    writeMat( out, average );
+
+    return out.good();
+}
+
+bool RunningAverageBackgroundModel::load(const std::string &file)
+{
+    std::ifstream in( file.c_str(), std::ios::binary );
+    cv::Mat loaded;
+
+    if ( !in || !readTag( in, RUNNING_AVERAGE_TAG ) || !readMat( in, loaded, CV_16UC3 ) )
+        return false;
+
+    average = loaded;
+    return true;
+}
+
+void RunningAverageBackgroundModel::setLearningShift(int learning_shift)
+{
+    this->learning_shift = std::max( 0, std::min( 8, learning_shift ) );
+}
+
+void RunningAverageBackgroundModel::setThreshold(int threshold)
+{
+    this->threshold = std::max( 0, std::min( 255, threshold ) );
+}
@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+//-- RunningAverageBackgroundModel
+//------------------------------------------------------------------------------
+//--
+//-- Background model based on an exponential running average
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file RunningAverageBackgroundModel.h
+ *  \brief Background model based on an exponential running average
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef RUNNINGAVERAGEBACKGROUNDMODEL_H
+#define RUNNINGAVERAGEBACKGROUNDMODEL_H
+
+#include <vector>
+#include "BackgroundModel.h"
+
+
+/*! \class RunningAverageBackgroundModel
+ *  \brief Background model based on an exponential running average
+ *
+ *  The background is the running average of the frames, kept in 8.8 fixed point, with a learning
+ *  rate that is a power of two so the update is just shifts and additions. A pixel is foreground if
+ *  any of its channels differs from the background by more than a threshold. Uses SSE2 / AVX2 over
+ *  the 8 bit data when the compiler targets them.
+ *
+ *  Good enough for fixed cameras, and several times cheaper than MOG2.
+ */
+class RunningAverageBackgroundModel : public BackgroundModel
+{
+    public:
+        /*! \brief Creates the model
+         *  \param learning_shift The learning rate is 1 / 2^learning_shift (from 0 to 8)
+         *  \param threshold Min. difference in any channel for a pixel to be foreground
+         */
+        RunningAverageBackgroundModel( int learning_shift = 5, int threshold = 20 );
+
+        void apply( const cv::Mat& frame, cv::Mat& foreground );
+        void getBackgroundImage( cv::Mat& background );
+        bool save( const std::string& file );
+        bool load( const std::string& file );
+
+        //! \brief Sets the learning rate to 1 / 2^learning_shift (from 0 to 8)
+        void setLearningShift( int learning_shift );
+
+        //! \brief Sets the min. difference in any channel for a pixel to be foreground
+        void setThreshold( int threshold );
+
+    private:
+        cv::Mat average;                //!< \brief Background, in 8.8 fixed point (CV_16UC3)
+        std::vector<uchar> changed;     //!< \brief Per-channel foreground flags of one row
+        int learning_shift;             //!< \brief Learning rate is 1 / 2^learning_shift
+        int threshold;                  //!< \brief Min. difference for a channel to be foreground
+};
+
+#endif // RUNNINGAVERAGEBACKGROUNDMODEL_H
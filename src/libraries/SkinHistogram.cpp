@@ -0,0 +1,234 @@
+//------------------------------------------------------------------------------
+//-- SkinHistogram
+//------------------------------------------------------------------------------
+//--
+//-- Probabilistic skin color model based on a Hue-Saturation histogram
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file SkinHistogram.cpp
+ *  \brief Probabilistic skin color model based on a Hue-Saturation histogram
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "SkinHistogram.h"
+
+SkinHistogram::SkinHistogram()
+{
+    model = std::vector<uchar>( HUE_BINS * SAT_BINS, 0 );
+    learnt = false;
+    samples.assign( HUE_BINS * SAT_BINS, 0 );
+    num_samples = 0;
+    version = 0;
+    bakedVersion = -1;
+    bakedGeneration = -1;
+    bakedCutoff = bakedVLo = bakedVHi = -1;
+}
+
+void SkinHistogram::learn(const cv::Mat &ROI)
+{
+    //-- Convert from BGR to HSV (the sample is small)
+    cv::Mat HSV_ROI;
+    cv::cvtColor( ROI, HSV_ROI, CV_BGR2HSV);
+
+    //-- Count samples
+    std::vector<int> counts( HUE_BINS * SAT_BINS, 0 );
+    for ( int i = 0; i < HSV_ROI.rows; i++ )
+    {
+        const uchar * p = HSV_ROI.ptr<uchar>(i);
+        for ( int j = 0; j < HSV_ROI.cols; j++, p += 3 )
+            counts[ ( p[0] * HUE_BINS / 180 ) * SAT_BINS + p[1] * SAT_BINS / 256 ]++;
+    }
+
+    learnt = normalize( counts, model );
+    version++;
+
+    //-- This is the reference for the adaptation from now on:
+    calibrated = model;
+    previous.clear();
+    samples.assign( HUE_BINS * SAT_BINS, 0 );
+    num_samples = 0;
+}
+
+bool SkinHistogram::isLearnt() const
+{
+    return learnt;
+}
+
+void SkinHistogram::accumulate(const cv::Mat &bgr, const cv::Mat &mask, int step)
+{
+    CV_Assert( bgr.type() == CV_8UC3 && mask.type() == CV_8UC1 && bgr.size() == mask.size() );
+
+    //-- Only the hand region is converted, it is small
+    cv::cvtColor( bgr, sampleHSV, CV_BGR2HSV );
+
+    for ( int i = 0; i < sampleHSV.rows; i += step )
+    {
+        const uchar * p = sampleHSV.ptr<uchar>(i);
+        const uchar * m = mask.ptr<uchar>(i);
+
+        for ( int j = 0; j < sampleHSV.cols; j += step )
+            if ( m[j] )
+            {
+                samples[ ( p[3*j] * HUE_BINS / 180 ) * SAT_BINS + p[3*j+1] * SAT_BINS / 256 ]++;
+                num_samples++;
+            }
+    }
+}
+
+int SkinHistogram::getAccumulatedSamples() const
+{
+    return num_samples;
+}
+
+bool SkinHistogram::adapt(double rate, double min_similarity)
+{
+    std::vector<uchar> sample_model;
+    bool has_samples = learnt && normalize( samples, sample_model );
+
+    samples.assign( HUE_BINS * SAT_BINS, 0 );
+    num_samples = 0;
+
+    if ( !has_samples )
+        return false;
+
+    //-- Blend the samples into the current model:
+    std::vector<uchar> candidate( HUE_BINS * SAT_BINS );
+    for ( int i = 0; i < HUE_BINS * SAT_BINS; i++ )
+        candidate[i] = (uchar) ( ( 1 - rate ) * model[i] + rate * sample_model[i] + 0.5 );
+
+    //-- Drift guard: the skin may change with the lighting, but not become something else
+    if ( similarity( candidate, calibrated ) < min_similarity )
+        return false;
+
+    previous = model;
+    model = candidate;
+    version++;
+    return true;
+}
+
+bool SkinHistogram::rollback()
+{
+    if ( previous.empty() )
+        return false;
+
+    model = previous;
+    previous.clear();
+    version++;
+    return true;
+}
+
+void SkinHistogram::write(cv::FileStorage &fs) const
+{
+    fs << "{" << "hue_bins" << HUE_BINS << "sat_bins" << SAT_BINS
+       << "model" << model << "calibrated" << calibrated << "}";
+}
+
+bool SkinHistogram::read(const cv::FileNode &node)
+{
+    if ( (int) node["hue_bins"] != HUE_BINS || (int) node["sat_bins"] != SAT_BINS )
+        return false;
+
+    std::vector<uchar> new_model, new_calibrated;
+    node["model"] >> new_model;
+    node["calibrated"] >> new_calibrated;
+
+    if ( new_model.size() != model.size() )
+        return false;
+
+    model = new_model;
+    calibrated = new_calibrated.size() == model.size() ? new_calibrated : model;
+    previous.clear();
+    samples.assign( HUE_BINS * SAT_BINS, 0 );
+    num_samples = 0;
+
+    learnt = true;
+    version++;
+    return true;
+}
+
+bool SkinHistogram::normalize(const std::vector<int> &counts, std::vector<uchar> &model)
+{
+    //-- Smooth with a 3x3 box (hue is circular) so that a small sample does not leave holes
+    std::vector<int> smoothed( HUE_BINS * SAT_BINS, 0 );
+    int max_count = 0;
+    for ( int h = 0; h < HUE_BINS; h++ )
+        for ( int s = 0; s < SAT_BINS; s++ )
+        {
+            int sum = 0;
+            for ( int dh = -1; dh <= 1; dh++ )
+                for ( int ds = -1; ds <= 1; ds++ )
+                {
+                    int hh = ( h + dh + HUE_BINS ) % HUE_BINS;
+                    int ss = s + ds;
+                    if ( ss >= 0 && ss < SAT_BINS )
+                        sum += counts[ hh * SAT_BINS + ss ];
+                }
+
+            smoothed[ h * SAT_BINS + s ] = sum;
+            max_count = std::max( max_count, sum );
+        }
+
+    //-- Normalize to [0-255]
+    model.resize( HUE_BINS * SAT_BINS );
+    for ( int i = 0; i < HUE_BINS * SAT_BINS; i++ )
+        model[i] = max_count > 0 ? (uchar) ( (long long) smoothed[i] * 255 / max_count ) : 0;
+
+    return max_count > 0;
+}
+
+double SkinHistogram::similarity(const std::vector<uchar> &a, const std::vector<uchar> &b)
+{
+    int intersection = 0, sum_a = 0, sum_b = 0;
+    for ( int i = 0; i < HUE_BINS * SAT_BINS; i++ )
+    {
+        intersection += std::min( a[i], b[i] );
+        sum_a += a[i];
+        sum_b += b[i];
+    }
+
+    int sum = std::max( sum_a, sum_b );
+    return sum > 0 ? intersection / (double) sum : 0;
+}
+
+void SkinHistogram::bake(SkinLUT &lut, int cutoff, int v_lo, int v_hi)
+{
+    //-- Skip if nothing changed
+    if ( bakedVersion == version && bakedGeneration == lut.getGeneration()
+         && bakedCutoff == cutoff && bakedVLo == v_lo && bakedVHi == v_hi )
+        return;
+
+    //-- HSV of the cell centers is computed once
+    if ( cellHSV.empty() )
+        cv::cvtColor( lut.getCellCenters(), cellHSV, CV_BGR2HSV );
+
+    cellMask.create( cellHSV.size(), CV_8UC1 );
+
+    const uchar * hsv = cellHSV.ptr<uchar>();
+    uchar * mask = cellMask.ptr<uchar>();
+    for ( int i = 0; i < SkinLUT::NUM_CELLS; i++, hsv += 3 )
+    {
+        bool skin = hsv[2] >= v_lo && hsv[2] <= v_hi && likelihood( hsv[0], hsv[1] ) >= cutoff;
+        mask[i] = skin ? 255 : 0;
+    }
+
+    lut.build( cellMask );
+
+    bakedVersion = version;
+    bakedGeneration = lut.getGeneration();
+    bakedCutoff = cutoff;
+    bakedVLo = v_lo;
+    bakedVHi = v_hi;
+}
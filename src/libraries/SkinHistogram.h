@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+//-- SkinHistogram
+//------------------------------------------------------------------------------
+//--
+//-- Probabilistic skin color model based on a Hue-Saturation histogram
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file SkinHistogram.h
+ *  \brief Probabilistic skin color model based on a Hue-Saturation histogram
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef SKINHISTOGRAM_H
+#define SKINHISTOGRAM_H
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "SkinLUT.h"
+
+
+/*! \class SkinHistogram
+ *  \brief Skin likelihood learnt from a sample of the user's skin
+ *
+ *  The model is a 2D histogram over Hue and Saturation, normalized so that the most frequent
+ *  bin has likelihood 255. Back-projection is done by baking the model into a SkinLUT: every
+ *  cell of the table is classified once with integer lookups, and thresholding a frame is then
+ *  a table lookup per pixel.
+ *
+ *  The model can also follow slow changes of the lighting: samples of confirmed hand pixels are
+ *  accumulated, and adapt() blends them into the model. An update that takes the model too far from
+ *  the calibrated one is rejected, and the last update can be undone with rollback().
+ */
+class SkinHistogram
+{
+    public:
+        static const int HUE_BINS = 30;         //!< \brief Number of hue bins (6 hue units each)
+        static const int SAT_BINS = 32;         //!< \brief Number of saturation bins (8 units each)
+
+        //! \brief Creates an empty model (every likelihood is 0)
+        SkinHistogram();
+
+        /*! \brief Learns the model from a sample of skin
+         *  \param ROI BGR image containing only skin
+         */
+        void learn( const cv::Mat& ROI );
+
+        //! \brief Returns true if the model has been learnt
+        bool isLearnt() const;
+
+        /*! \brief Accumulates samples of skin for the next adapt()
+         *  \param bgr BGR image
+         *  \param mask Pixels of bgr that are skin (CV_8UC1, same size)
+         *  \param step Only one of every step x step pixels is sampled
+         */
+        void accumulate( const cv::Mat& bgr, const cv::Mat& mask, int step = 2 );
+
+        //! \brief Returns the number of samples accumulated since the last adapt()
+        int getAccumulatedSamples() const;
+
+        /*! \brief Blends the accumulated samples into the model, and clears them
+         *
+         *  \param rate Weight of the samples in the new model [0-1]
+         *  \param min_similarity Min. histogram intersection [0-1] of the new model with the calibrated one
+         *  \return True if the model was updated, false if the update was rejected or there was nothing to learn
+         */
+        bool adapt( double rate, double min_similarity );
+
+        //! \brief Undoes the last successful adapt(). Returns false if there is nothing to undo
+        bool rollback();
+
+        //! \brief Writes the model (and the calibrated one) to a file storage, in the current node
+        void write( cv::FileStorage& fs ) const;
+
+        //! \brief Reads a model written by write(). Returns false, leaving the model unchanged, if not valid
+        bool read( const cv::FileNode& node );
+
+        //! \brief Returns the likelihood [0-255] of a HSV color being skin
+        inline int likelihood( int hue, int saturation ) const
+        {
+            return model[ ( hue * HUE_BINS / 180 ) * SAT_BINS + saturation * SAT_BINS / 256 ];
+        }
+
+        /*! \brief Back-projects the model into a lookup table
+         *
+         *  The table is only rebuilt if the model, the parameters or the table itself changed since the last call.
+         *
+         *  \param lut Table to fill
+         *  \param cutoff Minimum likelihood [0-255] for a color to be considered skin
+         *  \param v_lo Minimum value (brightness) for a color to be considered skin
+         *  \param v_hi Maximum value (brightness) for a color to be considered skin
+         */
+        void bake( SkinLUT& lut, int cutoff, int v_lo = 0, int v_hi = 255 );
+
+    private:
+        //! \brief Builds a [0-255] model from bin counts, smoothed with a 3x3 box. Returns false if empty
+        static bool normalize( const std::vector<int>& counts, std::vector<uchar>& model );
+
+        //! \brief Histogram intersection of two models, normalized to [0-1]
+        static double similarity( const std::vector<uchar>& a, const std::vector<uchar>& b );
+
+        std::vector<uchar> model;   //!< \brief HUE_BINS x SAT_BINS likelihoods
+        bool learnt;                //!< \brief True once learn() has been called
+
+        std::vector<uchar> calibrated;  //!< \brief Model learnt on calibration, reference for the drift guard
+        std::vector<uchar> previous;    //!< \brief Model before the last adapt(), for rollback (empty if none)
+        std::vector<int> samples;       //!< \brief Counts of the samples accumulated for adapt()
+        int num_samples;                //!< \brief Number of samples accumulated for adapt()
+        cv::Mat sampleHSV;              //!< \brief Buffer for the HSV conversion of the samples
+
+        cv::Mat cellHSV;            //!< \brief HSV color of each SkinLUT cell center (built on first use)
+        cv::Mat cellMask;           //!< \brief Buffer for the classification of the cells
+
+        int bakedVersion;           //!< \brief Model version last baked into a table (-1 if none)
+        int bakedGeneration;        //!< \brief Generation of the table after the last bake
+        int version;                //!< \brief Incremented each time the model is learnt
+        int bakedCutoff, bakedVLo, bakedVHi; //!< \brief Parameters of the last bake
+};
+
+#endif // SKINHISTOGRAM_H
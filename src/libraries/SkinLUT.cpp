@@ -0,0 +1,299 @@
+//------------------------------------------------------------------------------
+//-- SkinLUT
+//------------------------------------------------------------------------------
+//--
+//-- Quantized BGR lookup table for fast skin segmentation
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file SkinLUT.cpp
+ *  \brief Quantized BGR lookup table for fast skin segmentation
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "SkinLUT.h"
+#include <algorithm>
+
+SkinLUT::SkinLUT()
+{
+    table = std::vector<unsigned int>( NUM_CELLS / 32, 0 );
+    boxValid = false;
+    boxWrapHue = false;
+    boxColorSpace = GECKO_COLOR_SPACE_HSV;
+    generation = 0;
+
+    yuvGeneration = -1;
+
+    channelValue.resize( 3 * 256 );
+    channelIndex.resize( 3 * 256 );
+    gains = cv::Scalar::all( 0 );
+    setGains( cv::Scalar::all( 1 ) );
+}
+
+void SkinLUT::build(const cv::Scalar &lower, const cv::Scalar &upper, bool wrap_hue, unsigned int color_space)
+{
+    //-- Skip the rebuild if nothing changed
+    if ( boxValid && wrap_hue == boxWrapHue && color_space == boxColorSpace )
+    {
+        bool same = true;
+        for ( int i = 0; i < 3; i++ )
+            if ( lower[i] != boxLower[i] || upper[i] != boxUpper[i] )
+                same = false;
+
+        if ( same )
+            return;
+    }
+
+    //-- Classify the cell centers with the exact kernel of the color space
+    thresholdBox( getCellCenters(), cellMask, color_space, lower, upper, wrap_hue );
+    build( cellMask );
+
+    boxValid = true;
+    boxLower = lower;
+    boxUpper = upper;
+    boxWrapHue = wrap_hue;
+    boxColorSpace = color_space;
+}
+
+void SkinLUT::build(const cv::Mat &cellMask)
+{
+    CV_Assert( cellMask.type() == CV_8UC1 && (int) cellMask.total() == NUM_CELLS && cellMask.isContinuous() );
+
+    const uchar * mask = cellMask.ptr<uchar>();
+    for ( int w = 0; w < NUM_CELLS / 32; w++ )
+    {
+        unsigned int word = 0;
+        for ( int bit = 0; bit < 32; bit++ )
+            word |= ( mask[ w * 32 + bit ] ? 1u : 0u ) << bit;
+        table[w] = word;
+    }
+
+    //-- The table no longer corresponds to a HSV box
+    boxValid = false;
+    generation++;
+}
+
+int SkinLUT::getGeneration() const
+{
+    return generation;
+}
+
+void SkinLUT::setGains(const cv::Scalar &gains)
+{
+    if ( gains == this->gains )
+        return;
+
+    this->gains = gains;
+
+    for ( int c = 0; c < 3; c++ )
+        for ( int v = 0; v < 256; v++ )
+        {
+            uchar value = cv::saturate_cast<uchar>( v * gains[c] );
+            channelValue[ c * 256 + v ] = value;
+            channelIndex[ c * 256 + v ] = ( value >> 2 ) << ( 6 * ( 2 - c ) );
+        }
+}
+
+cv::Scalar SkinLUT::getGains() const
+{
+    return gains;
+}
+
+void SkinLUT::normalize(const cv::Mat &src, cv::Mat &dst) const
+{
+    CV_Assert( src.type() == CV_8UC3 );
+    dst.create( src.size(), CV_8UC3 );
+
+    const uchar * lut = &channelValue[0];
+
+    for ( int i = 0; i < src.rows; i++ )
+    {
+        const uchar * s = src.ptr<uchar>(i);
+        uchar * d = dst.ptr<uchar>(i);
+
+        for ( int j = 0; j < src.cols; j++, s += 3, d += 3 )
+        {
+            d[0] = lut[ s[0] ];
+            d[1] = lut[ 256 + s[1] ];
+            d[2] = lut[ 512 + s[2] ];
+        }
+    }
+}
+
+const cv::Mat& SkinLUT::getCellCenters()
+{
+    if ( cellCenters.empty() )
+    {
+        cellCenters.create( 1, NUM_CELLS, CV_8UC3 );
+        uchar * p = cellCenters.ptr<uchar>();
+
+        //-- Cell index is b:g:r with 6 bits each, the center of a cell adds half a step (2)
+        for ( int b = 0; b < CELLS_PER_CHANNEL; b++ )
+            for ( int g = 0; g < CELLS_PER_CHANNEL; g++ )
+                for ( int r = 0; r < CELLS_PER_CHANNEL; r++ )
+                {
+                    *p++ = ( b << 2 ) | 2;
+                    *p++ = ( g << 2 ) | 2;
+                    *p++ = ( r << 2 ) | 2;
+                }
+    }
+
+    return cellCenters;
+}
+
+void SkinLUT::apply(const cv::Mat &src, cv::Mat &dst) const
+{
+    CV_Assert( src.type() == CV_8UC3 );
+    dst.create( src.size(), CV_8UC1 );
+
+    const unsigned int * t = &table[0];
+
+    for ( int i = 0; i < src.rows; i++ )
+    {
+        const uchar * s = src.ptr<uchar>(i);
+        uchar * d = dst.ptr<uchar>(i);
+
+        for ( int j = 0; j < src.cols; j++, s += 3 )
+        {
+            int index = gainedIndex( s[0], s[1], s[2] );
+            d[j] = (uchar) -(int) ( ( t[ index >> 5 ] >> ( index & 31 ) ) & 1 );
+        }
+    }
+}
+
+void SkinLUT::apply(const cv::Mat &src, BitMask &dst) const
+{
+    CV_Assert( src.type() == CV_8UC3 );
+    dst.create( src.rows, src.cols );
+
+    const unsigned int * t = &table[0];
+
+    for ( int i = 0; i < src.rows; i++ )
+    {
+        const uchar * s = src.ptr<uchar>(i);
+        uint64_t * d = dst.row(i);
+
+        for ( int k = 0; k < dst.getWordsPerRow(); k++ )
+        {
+            int end = std::min( src.cols - k * 64, 64 );
+            uint64_t word = 0;
+
+            for ( int b = 0; b < end; b++, s += 3 )
+            {
+                int index = gainedIndex( s[0], s[1], s[2] );
+                word |= (uint64_t) ( ( t[ index >> 5 ] >> ( index & 31 ) ) & 1 ) << b;
+            }
+
+            d[k] = word;
+        }
+    }
+}
+
+void SkinLUT::apply(const cv::Mat &src, const BitMask &mask, BitMask &dst) const
+{
+    CV_Assert( src.type() == CV_8UC3 && mask.getRows() == src.rows && mask.getCols() == src.cols );
+    dst.create( src.rows, src.cols );
+
+    const unsigned int * t = &table[0];
+
+    for ( int i = 0; i < src.rows; i++ )
+    {
+        const uchar * s = src.ptr<uchar>(i);
+        const uint64_t * m = mask.row(i);
+        uint64_t * d = dst.row(i);
+
+        for ( int k = 0; k < dst.getWordsPerRow(); k++ )
+        {
+            uint64_t word = 0;
+
+            //-- Visit only the bits set in the mask:
+            for ( uint64_t pending = m[k]; pending; pending &= pending - 1 )
+            {
+                int b = __builtin_ctzll( pending );
+                const uchar * p = s + 3 * ( k * 64 + b );
+                int index = gainedIndex( p[0], p[1], p[2] );
+                word |= (uint64_t) ( ( t[ index >> 5 ] >> ( index & 31 ) ) & 1 ) << b;
+            }
+
+            d[k] = word;
+        }
+    }
+}
+
+void SkinLUT::apply(const cv::Mat &src, unsigned int format, const BitMask &mask, BitMask &dst)
+{
+    bool nv12 = format == FramePyramid::GECKO_FORMAT_NV12;
+    int rows = nv12 ? src.rows * 2 / 3 : src.rows;
+
+    CV_Assert( ( nv12 ? src.type() == CV_8UC1 : format == FramePyramid::GECKO_FORMAT_YUYV && src.type() == CV_8UC2 )
+               && mask.getRows() == rows && mask.getCols() == src.cols );
+    dst.create( rows, src.cols );
+
+    updateYUVTable();
+    const unsigned int * t = &tableYUV[0];
+
+    for ( int i = 0; i < rows; i++ )
+    {
+        const uchar * y = src.ptr<uchar>(i);
+        const uchar * uv = nv12 ? src.ptr<uchar>( rows + i / 2 ) : NULL;
+        const uint64_t * m = mask.row(i);
+        uint64_t * d = dst.row(i);
+
+        for ( int k = 0; k < dst.getWordsPerRow(); k++ )
+        {
+            uint64_t word = 0;
+
+            //-- Visit only the bits set in the mask:
+            for ( uint64_t pending = m[k]; pending; pending &= pending - 1 )
+            {
+                int b = __builtin_ctzll( pending );
+                int j = k * 64 + b;
+
+                //-- YUYV: Y0 U Y1 V for each pair of pixels. NV12: U V for each pair of pixels and rows
+                const uchar * chroma = nv12 ? uv + ( j & ~1 ) : y + 4 * ( j >> 1 ) + 1;
+                int luma = nv12 ? y[j] : y[ 2 * j ];
+
+                int index = cellIndex( luma, chroma[0], chroma[ nv12 ? 1 : 2 ] );
+                word |= (uint64_t) ( ( t[ index >> 5 ] >> ( index & 31 ) ) & 1 ) << b;
+            }
+
+            d[k] = word;
+        }
+    }
+}
+
+void SkinLUT::updateYUVTable()
+{
+    if ( yuvGeneration == generation && yuvGains == gains && !tableYUV.empty() )
+        return;
+
+    tableYUV.assign( NUM_CELLS / 32, 0 );
+
+    //-- Each YUV cell is skin if the BGR color of its center is
+    int index = 0;
+    for ( int y = 0; y < CELLS_PER_CHANNEL; y++ )
+        for ( int u = 0; u < CELLS_PER_CHANNEL; u++ )
+            for ( int v = 0; v < CELLS_PER_CHANNEL; v++, index++ )
+            {
+                uchar bgr[3];
+                FramePyramid::yuvToBGR( ( y << 2 ) | 2, ( u << 2 ) | 2, ( v << 2 ) | 2, bgr );
+
+                if ( isSkin( bgr[0], bgr[1], bgr[2] ) )
+                    tableYUV[ index >> 5 ] |= 1u << ( index & 31 );
+            }
+
+    yuvGeneration = generation;
+    yuvGains = gains;
+}
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+//-- SkinLUT
+//------------------------------------------------------------------------------
+//--
+//-- Quantized BGR lookup table for fast skin segmentation
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file SkinLUT.h
+ *  \brief Quantized BGR lookup table for fast skin segmentation
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef SKINLUT_H
+#define SKINLUT_H
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "skinThreshold.h"
+#include "BitMask.h"
+#include "FramePyramid.h"
+
+
+/*! \class SkinLUT
+ *  \brief Classifies BGR pixels as skin / not skin with a single table lookup
+ *
+ *  Each channel is quantized to 6 bits, giving a 64x64x64 table with one bit per cell (32 KB,
+ *  small enough to stay in L2 cache). Every cell is classified once, using the color at its
+ *  center, so thresholding a frame becomes a gather from the table.
+ *
+ *  Any skin model can be baked into the table: classify the image returned by getCellCenters()
+ *  and pass the resulting mask to build().
+ *
+ *  A per-channel gain can be applied to the pixels before the classification, to compensate for
+ *  changes of the lighting. The gains are folded into the per-channel tables that compute the cell
+ *  index, so they cost nothing in the thresholding pass.
+ *
+ *  YUV frames are classified with a second table, indexed by the quantized Y, U and V, that is
+ *  derived from the BGR one the first time it is needed after a change.
+ */
+class SkinLUT
+{
+    public:
+        static const int BITS_PER_CHANNEL = 6;                  //!< \brief Bits kept from each channel
+        static const int CELLS_PER_CHANNEL = 1 << BITS_PER_CHANNEL; //!< \brief Table side
+        static const int NUM_CELLS = CELLS_PER_CHANNEL * CELLS_PER_CHANNEL * CELLS_PER_CHANNEL; //!< \brief Number of cells
+
+        //! \brief Creates an empty table (no pixel is skin)
+        SkinLUT();
+
+        /*! \brief Fills the table from a box in a color space (HSV by default)
+         *
+         *  The table is only rebuilt if the box differs from the one used on the last call,
+         *  so it can be called every frame (e.g. from the calibration trackbars).
+         *
+         *  \param lower Lower limit of the box
+         *  \param upper Upper limit of the box
+         *  \param wrap_hue If true, the hue range wraps around 0 (see thresholdHSV())
+         *  \param color_space One of the GECKO_COLOR_SPACE_* constants (see thresholdBox())
+         */
+        void build( const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue = false,
+                    unsigned int color_space = GECKO_COLOR_SPACE_HSV );
+
+        /*! \brief Fills the table from an arbitrary classification of the cell centers
+         *  \param cellMask CV_8UC1 image with the same layout as getCellCenters(), non-zero for skin cells
+         */
+        void build( const cv::Mat& cellMask );
+
+        //! \brief Returns a counter that is incremented every time the table contents change
+        int getGeneration() const;
+
+        //! \brief Returns a 1 x NUM_CELLS BGR image with the color each cell stands for
+        const cv::Mat& getCellCenters();
+
+        /*! \brief Sets the gain applied to each channel of the pixels before classifying them
+         *
+         *  The table itself is not changed (nor its generation), only the way pixels are mapped to it.
+         *
+         *  \param gains B, G and R gains (1 leaves the channel unchanged)
+         */
+        void setGains( const cv::Scalar& gains );
+
+        //! \brief Returns the gain applied to each channel
+        cv::Scalar getGains() const;
+
+        //! \brief Applies the channel gains to a BGR image, to get the colors the table sees
+        void normalize( const cv::Mat& src, cv::Mat& dst ) const;
+
+        /*! \brief Thresholds a BGR image using the table
+         *  \param src BGR input image (CV_8UC3)
+         *  \param dst Binary output image (CV_8UC1)
+         */
+        void apply( const cv::Mat& src, cv::Mat& dst ) const;
+
+        /*! \brief Thresholds a BGR image using the table, into a bit-packed mask
+         *  \param src BGR input image (CV_8UC3)
+         *  \param dst Output mask
+         */
+        void apply( const cv::Mat& src, BitMask& dst ) const;
+
+        /*! \brief Thresholds only the pixels of a BGR image that are set in a mask, into a bit-packed mask
+         *
+         *  Pixels outside the mask are not read, and are not skin. This fuses the background removal
+         *  with the thresholding, so the background pixels are never copied nor cleared.
+         *
+         *  \param src BGR input image (CV_8UC3)
+         *  \param mask Pixels to classify, of the same size as src
+         *  \param dst Output mask (may be mask)
+         */
+        void apply( const cv::Mat& src, const BitMask& mask, BitMask& dst ) const;
+
+        /*! \brief Thresholds only the pixels of a YUV frame that are set in a mask, into a bit-packed mask
+         *
+         *  The frame is tested in YUV straight away, without converting it to BGR. The YUV table is
+         *  rebuilt first if the BGR table or the gains have changed since it was last built.
+         *
+         *  \param src YUYV or NV12 frame (see FramePyramid)
+         *  \param format FramePyramid::GECKO_FORMAT_YUYV or FramePyramid::GECKO_FORMAT_NV12
+         *  \param mask Pixels to classify, of the size of the frame
+         *  \param dst Output mask (may be mask)
+         */
+        void apply( const cv::Mat& src, unsigned int format, const BitMask& mask, BitMask& dst );
+
+        //! \brief Returns true if the pixel is classified as skin
+        inline bool isSkin( uchar b, uchar g, uchar r ) const
+        {
+            int index = gainedIndex( b, g, r );
+            return ( table[ index >> 5 ] >> ( index & 31 ) ) & 1;
+        }
+
+        //! \brief Index of the cell that contains the pixel, once the channel gains are applied
+        inline int gainedIndex( uchar b, uchar g, uchar r ) const
+        {
+            return channelIndex[b] | channelIndex[ 256 + g ] | channelIndex[ 512 + r ];
+        }
+
+        //! \brief Index of the cell that contains the pixel
+        static inline int cellIndex( uchar b, uchar g, uchar r )
+        {
+            return ( ( b >> 2 ) << 12 ) | ( ( g >> 2 ) << 6 ) | ( r >> 2 );
+        }
+
+    private:
+        std::vector<unsigned int> table;    //!< \brief One bit per cell, packed in 32 bit words
+        cv::Mat cellCenters;                //!< \brief Color at the center of each cell (built on first use)
+        cv::Mat cellMask;                   //!< \brief Buffer for the classification of the cell centers
+        int generation;                     //!< \brief Number of times the table has been built
+
+        cv::Scalar gains;                   //!< \brief Gain of each channel
+        std::vector<uchar> channelValue;    //!< \brief Value of each channel after the gain (3 x 256)
+        std::vector<int> channelIndex;      //!< \brief Contribution of each channel value to the cell index (3 x 256)
+
+        std::vector<unsigned int> tableYUV; //!< \brief One bit per YUV cell, packed in 32 bit words
+        int yuvGeneration;                  //!< \brief Generation of the table tableYUV was built from (-1 if never)
+        cv::Scalar yuvGains;                //!< \brief Gains tableYUV was built with
+
+        //! \brief Rebuilds tableYUV if the table or the gains changed
+        void updateYUVTable();
+
+        bool boxValid;                      //!< \brief True if the table holds the box below
+        cv::Scalar boxLower;                //!< \brief Lower limit of the last box built
+        cv::Scalar boxUpper;                //!< \brief Upper limit of the last box built
+        bool boxWrapHue;                    //!< \brief Hue wrapping of the last box built
+        unsigned int boxColorSpace;         //!< \brief Color space of the last box built
+};
+
+#endif // SKINLUT_H
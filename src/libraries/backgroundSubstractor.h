@@ -35,6 +35,23 @@ class backgroundSubstractor: public cv::BackgroundSubtractorMOG2
 {
 public:
     void setbackgroundRatio(float a){backgroundRatio = a;}
+
+    //-- Access to the learnt model, to save and restore it:
+    int getMixtures(){return nmixtures;}
+    int getFrames(){return nframes;}
+    cv::Size getFrameSize(){return frameSize;}
+    int getFrameType(){return frameType;}
+    const cv::Mat& getModel(){return bgmodel;}
+    const cv::Mat& getUsedModes(){return bgmodelUsedModes;}
+
+    void setState(cv::Size size, int type, int frames, const cv::Mat& model, const cv::Mat& usedModes)
+    {
+        frameSize = size;
+        frameType = type;
+        nframes = frames;
+        bgmodel = model;
+        bgmodelUsedModes = usedModes;
+    }
 };
 
 #endif // BACKGROUNDSUBSTRACTOR_H
@@ -0,0 +1,283 @@
+//------------------------------------------------------------------------------
+//-- connectedComponents
+//------------------------------------------------------------------------------
+//--
+//-- Connected component labelling of binary masks, with per-blob statistics
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file connectedComponents.cpp
+ *  \brief Connected component labelling of binary masks, with per-blob statistics
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "connectedComponents.h"
+#include <algorithm>
+
+namespace
+{
+    int findRoot( std::vector<int>& parent, int label )
+    {
+        int root = label;
+        while ( parent[root] != root )
+            root = parent[root];
+
+        //-- Path compression:
+        while ( parent[label] != root )
+        {
+            int next = parent[label];
+            parent[label] = root;
+            label = next;
+        }
+
+        return root;
+    }
+
+    //-- Merges two provisional labels, returns the resulting root
+    int merge( std::vector<int>& parent, int a, int b )
+    {
+        a = findRoot( parent, a );
+        b = findRoot( parent, b );
+
+        if ( a < b )
+        {
+            parent[b] = a;
+            return a;
+        }
+
+        parent[a] = b;
+        return b;
+    }
+
+    //-- Resets the buffers for a new image (label 0 is the background)
+    void startLabelling( BlobLabellingBuffers& buffers )
+    {
+        buffers.parent.assign( 1, 0 );
+        buffers.accumulators.resize( 1 );
+    }
+
+    //-- Labels a foreground pixel from its already labelled neighbours (W, NW, N, NE), and adds it
+    //-- to the statistics of its label
+    inline int labelPixel( BlobLabellingBuffers& buffers, const int * l, const int * up, int i, int j, int cols )
+    {
+        std::vector<int>& parent = buffers.parent;
+
+        int label = 0;
+        int neighbours[4] = { j > 0 ? l[j-1] : 0,
+                              up && j > 0 ? up[j-1] : 0,
+                              up ? up[j] : 0,
+                              up && j + 1 < cols ? up[j+1] : 0 };
+
+        for ( int k = 0; k < 4; k++ )
+            if ( neighbours[k] )
+                label = label ? merge( parent, label, neighbours[k] ) : neighbours[k];
+
+        if ( !label )
+        {
+            label = parent.size();
+            parent.push_back( label );
+
+            BlobAccumulator new_blob = { 0, j, i, j, i, 0, 0 };
+            buffers.accumulators.push_back( new_blob );
+        }
+
+        BlobAccumulator& acc = buffers.accumulators[label];
+        acc.area++;
+        acc.min_x = std::min( acc.min_x, j );
+        acc.max_x = std::max( acc.max_x, j );
+        acc.min_y = std::min( acc.min_y, i );
+        acc.max_y = std::max( acc.max_y, i );
+        acc.sum_x += j;
+        acc.sum_y += i;
+
+        return label;
+    }
+
+    //-- Resolves the provisional labels, computes the final statistics and relabels the image
+    void finishLabelling( cv::Mat& labels, std::vector<BlobStats>& blobs, BlobLabellingBuffers& buffers )
+    {
+        std::vector<int>& parent = buffers.parent;
+        std::vector<BlobAccumulator>& accumulators = buffers.accumulators;
+
+        //-- Resolve provisional labels into consecutive final labels
+        //---------------------------------------------------------------------------
+        std::vector<int>& final_label = buffers.final_label;
+        std::vector<BlobAccumulator>& merged = buffers.merged;
+        final_label.assign( parent.size(), 0 );
+        merged.clear();
+
+        for ( int label = 1; label < (int) parent.size(); label++ )
+        {
+            int root = findRoot( parent, label );
+
+            if ( root == label )
+            {
+                merged.push_back( accumulators[label] );
+                final_label[label] = merged.size();
+                continue;
+            }
+
+            //-- Roots always have smaller labels, so they are already resolved:
+            final_label[label] = final_label[root];
+            BlobAccumulator& dst = merged[ final_label[root] - 1 ];
+            const BlobAccumulator& src = accumulators[label];
+
+            dst.area += src.area;
+            dst.min_x = std::min( dst.min_x, src.min_x );
+            dst.max_x = std::max( dst.max_x, src.max_x );
+            dst.min_y = std::min( dst.min_y, src.min_y );
+            dst.max_y = std::max( dst.max_y, src.max_y );
+            dst.sum_x += src.sum_x;
+            dst.sum_y += src.sum_y;
+        }
+
+        blobs.resize( merged.size() );
+        for ( int i = 0; i < (int) merged.size(); i++ )
+        {
+            blobs[i].area = merged[i].area;
+            blobs[i].boundingBox = cv::Rect( merged[i].min_x, merged[i].min_y,
+                                             merged[i].max_x - merged[i].min_x + 1,
+                                             merged[i].max_y - merged[i].min_y + 1 );
+            blobs[i].centroid = cv::Point2d( merged[i].sum_x / merged[i].area, merged[i].sum_y / merged[i].area );
+        }
+
+        //-- Second scan: final labels
+        //---------------------------------------------------------------------------
+        for ( int i = 0; i < labels.rows; i++ )
+        {
+            int * l = labels.ptr<int>( i );
+            for ( int j = 0; j < labels.cols; j++ )
+                l[j] = final_label[ l[j] ];
+        }
+    }
+}
+
+void labelBlobs(const cv::Mat &mask, cv::Mat &labels, std::vector<BlobStats> &blobs)
+{
+    BlobLabellingBuffers buffers;
+    labelBlobs( mask, labels, blobs, buffers );
+}
+
+void labelBlobs(const cv::Mat &mask, cv::Mat &labels, std::vector<BlobStats> &blobs, BlobLabellingBuffers &buffers)
+{
+    CV_Assert( mask.type() == CV_8UC1 );
+
+    labels.create( mask.size(), CV_32SC1 );
+    startLabelling( buffers );
+
+    //-- First scan: provisional labels and statistics
+    //---------------------------------------------------------------------------
+    for ( int i = 0; i < mask.rows; i++ )
+    {
+        const uchar * m = mask.ptr<uchar>( i );
+        int * l = labels.ptr<int>( i );
+        const int * up = i > 0 ? labels.ptr<int>( i - 1 ) : NULL;
+
+        for ( int j = 0; j < mask.cols; j++ )
+            l[j] = m[j] ? labelPixel( buffers, l, up, i, j, mask.cols ) : 0;
+    }
+
+    finishLabelling( labels, blobs, buffers );
+}
+
+void labelBlobs(const BitMask &mask, cv::Mat &labels, std::vector<BlobStats> &blobs, BlobLabellingBuffers &buffers)
+{
+    labels.create( mask.getRows(), mask.getCols(), CV_32SC1 );
+    startLabelling( buffers );
+
+    //-- First scan, skipping 64 background pixels at a time:
+    //---------------------------------------------------------------------------
+    for ( int i = 0; i < mask.getRows(); i++ )
+    {
+        const uint64_t * m = mask.row( i );
+        int * l = labels.ptr<int>( i );
+        const int * up = i > 0 ? labels.ptr<int>( i - 1 ) : NULL;
+
+        for ( int k = 0; k < mask.getWordsPerRow(); k++ )
+        {
+            int begin = k * 64;
+            int end = std::min( begin + 64, mask.getCols() );
+
+            if ( !m[k] )
+            {
+                std::fill( l + begin, l + end, 0 );
+                continue;
+            }
+
+            for ( int j = begin; j < end; j++ )
+                l[j] = ( m[k] >> ( j - begin ) ) & 1 ? labelPixel( buffers, l, up, i, j, mask.getCols() ) : 0;
+        }
+    }
+
+    finishLabelling( labels, blobs, buffers );
+}
+
+void labelBlobs(const BitMask &mask, cv::Mat &labels, std::vector<BlobStats> &blobs)
+{
+    BlobLabellingBuffers buffers;
+    labelBlobs( mask, labels, blobs, buffers );
+}
+
+void keepBlobs(const cv::Mat &labels, const std::vector<BlobStats> &blobs, cv::Mat &dst, int min_area)
+{
+    dst.create( labels.size(), CV_8UC1 );
+
+    for ( int i = 0; i < labels.rows; i++ )
+    {
+        const int * l = labels.ptr<int>( i );
+        uchar * d = dst.ptr<uchar>( i );
+
+        for ( int j = 0; j < labels.cols; j++ )
+            d[j] = l[j] && blobs[ l[j] - 1 ].area >= min_area ? 255 : 0;
+    }
+}
+
+int largestBlob(const std::vector<BlobStats> &blobs, int min_area)
+{
+    int largest = -1;
+    int largest_area = min_area;
+
+    for ( int i = 0; i < (int) blobs.size(); i++ )
+        if ( blobs[i].area >= largest_area )
+        {
+            largest = i;
+            largest_area = blobs[i].area;
+        }
+
+    return largest;
+}
+
+void largestBlobs(const std::vector<BlobStats> &blobs, int min_area, int n, std::vector<int> &indices)
+{
+    indices.clear();
+
+    //-- Insertion into a sorted list of at most n elements (n is small):
+    for ( int i = 0; i < (int) blobs.size(); i++ )
+    {
+        if ( blobs[i].area < min_area )
+            continue;
+
+        int position = indices.size();
+        while ( position > 0 && blobs[ indices[position-1] ].area < blobs[i].area )
+            position--;
+
+        if ( position >= n )
+            continue;
+
+        indices.insert( indices.begin() + position, i );
+        if ( (int) indices.size() > n )
+            indices.pop_back();
+    }
+}
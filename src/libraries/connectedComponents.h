@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+//-- connectedComponents
+//------------------------------------------------------------------------------
+//--
+//-- Connected component labelling of binary masks, with per-blob statistics
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file connectedComponents.h
+ *  \brief Connected component labelling of binary masks, with per-blob statistics
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef CONNECTEDCOMPONENTS_H
+#define CONNECTEDCOMPONENTS_H
+
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+#include "BitMask.h"
+
+/*! \struct BlobStats
+ *  \brief Statistics of a connected component
+ */
+struct BlobStats
+{
+    int area;               //!< \brief Number of pixels
+    cv::Rect boundingBox;   //!< \brief Bounding box
+    cv::Point2d centroid;   //!< \brief Center of mass
+};
+
+/*! \struct BlobAccumulator
+ *  \brief Statistics of a connected component while it is being labelled
+ */
+struct BlobAccumulator
+{
+    int area;                       //!< \brief Number of pixels
+    int min_x, min_y, max_x, max_y; //!< \brief Bounding box limits (inclusive)
+    double sum_x, sum_y;            //!< \brief Sum of the coordinates of the pixels
+};
+
+/*! \struct BlobLabellingBuffers
+ *  \brief Scratch memory of labelBlobs(), to reuse it between calls
+ */
+struct BlobLabellingBuffers
+{
+    std::vector<int> parent;                    //!< \brief Union-find forest of the provisional labels
+    std::vector<int> final_label;               //!< \brief Final label of each provisional label
+    std::vector<BlobAccumulator> accumulators;  //!< \brief Statistics of each provisional label
+    std::vector<BlobAccumulator> merged;        //!< \brief Statistics of each final label
+};
+
+/*!
+ * \brief Labels the 8-connected components of a binary mask
+ *
+ * Runs in linear time: a raster scan assigns provisional labels and merges them with union-find while
+ * accumulating the statistics, and a second scan writes the final labels.
+ *
+ * \param mask Binary image (CV_8UC1), non-zero pixels are foreground
+ * \param labels Output image (CV_32SC1): 0 for background, i+1 for the pixels of blobs[i]
+ * \param blobs Statistics of each component
+ */
+void labelBlobs( const cv::Mat& mask, cv::Mat& labels, std::vector<BlobStats>& blobs );
+
+/*!
+ * \brief Labels the 8-connected components of a binary mask, reusing the given scratch memory
+ *
+ * Once the buffers have grown to the needs of the stream, nothing is allocated.
+ */
+void labelBlobs( const cv::Mat& mask, cv::Mat& labels, std::vector<BlobStats>& blobs, BlobLabellingBuffers& buffers );
+
+/*!
+ * \brief Labels the 8-connected components of a bit-packed mask
+ *
+ * Same output as the cv::Mat version, but whole words of background are skipped at once.
+ */
+void labelBlobs( const BitMask& mask, cv::Mat& labels, std::vector<BlobStats>& blobs );
+
+//! \brief Labels the 8-connected components of a bit-packed mask, reusing the given scratch memory
+void labelBlobs( const BitMask& mask, cv::Mat& labels, std::vector<BlobStats>& blobs, BlobLabellingBuffers& buffers );
+
+/*!
+ * \brief Builds a mask with the components that are large enough
+ *
+ * \param labels Labels image from labelBlobs()
+ * \param blobs Statistics from labelBlobs()
+ * \param dst Binary output image (CV_8UC1)
+ * \param min_area Minimum number of pixels of the components kept
+ */
+void keepBlobs( const cv::Mat& labels, const std::vector<BlobStats>& blobs, cv::Mat& dst, int min_area );
+
+/*!
+ * \brief Returns the index of the largest component, or -1 if none reaches min_area
+ */
+int largestBlob( const std::vector<BlobStats>& blobs, int min_area = 0 );
+
+/*!
+ * \brief Finds the n largest components reaching min_area
+ * \param indices Output indices of the components, largest first (fewer than n if not enough reach min_area)
+ */
+void largestBlobs( const std::vector<BlobStats>& blobs, int min_area, int n, std::vector<int>& indices );
+
+#endif // CONNECTEDCOMPONENTS_H
@@ -25,6 +25,50 @@
  */
 
 #include "handUtils.h"
+#include <cfloat>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+//-- Largest value of a row of floats
+static float rowMaximum( const float * row, int n )
+{
+    float maximum = -FLT_MAX;
+    int i = 0;
+
+#if defined(__SSE2__)
+    __m128 maxima = _mm_set1_ps( -FLT_MAX );
+
+#if defined(__AVX2__)
+    {
+        __m256 wide_maxima = _mm256_set1_ps( -FLT_MAX );
+        for ( ; i + 8 <= n; i += 8 )
+            wide_maxima = _mm256_max_ps( wide_maxima, _mm256_loadu_ps( row + i ) );
+
+        maxima = _mm_max_ps( _mm256_castps256_ps128( wide_maxima ), _mm256_extractf128_ps( wide_maxima, 1 ) );
+    }
+#endif
+
+    for ( ; i + 4 <= n; i += 4 )
+        maxima = _mm_max_ps( maxima, _mm_loadu_ps( row + i ) );
+
+    //-- Horizontal reduction of the four lanes:
+    maxima = _mm_max_ps( maxima, _mm_movehl_ps( maxima, maxima ) );
+    maxima = _mm_max_ss( maxima, _mm_shuffle_ps( maxima, maxima, 1 ) );
+    maximum = _mm_cvtss_f32( maxima );
+#endif
+
+    for ( ; i < n; i++ )
+        maximum = std::max( maximum, row[i] );
+
+    return maximum;
+}
 
 void drawCalibrationMarks( cv::Mat& input, cv::Mat& output, int halfSide, cv::Scalar color)
 {
@@ -43,52 +87,35 @@ void drawCalibrationMarks( cv::Mat& input, cv::Mat& output, int halfSide, cv::Sc
 
 void drawHistogram(const cv::Mat& img)
 {
-    int bins = 256;
+    int bins = ChannelStats::BINS;
     int nc = img.channels();
-    std::vector<cv::Mat> hist( nc);
-    std::vector<cv::Mat> canvas( nc);
-    int hmax[3] = {0,0,0};
-
-    for (int i = 0; i < hist.size(); i++)
-	hist[i] = cv::Mat::zeros(1, bins, CV_32SC1);
-
-    for (int i = 0; i < img.rows; i++)
-    {
-	for (int j = 0; j < img.cols; j++)
-	{
-	    for (int k = 0; k < nc; k++)
-	    {
-		uchar val = nc == 1 ? img.at<uchar>(i,j) : img.at<cv::Vec3b>(i,j)[k];
-		hist[k].at<int>(val) += 1;
-	    }
-	}
-    }
 
-    for (int i = 0; i < nc; i++)
-    {
-	for (int j = 0; j < bins-1; j++)
-	    hmax[i] = hist[i].at<int>(j) > hmax[i] ? hist[i].at<int>(j) : hmax[i];
-    }
+    //-- Histograms of all the channels, in a single pass:
+    ChannelStats stats( nc );
+    stats.accumulate( img );
 
     const char* wname[3] = { "channel 1", "channel 2", "channel 3" };
     cv::Scalar colors[3] = { cv::Scalar(255,0,0), cv::Scalar(0,255,0), cv::Scalar(0,0,255) };
 
     for (int i = 0; i < nc; i++)
     {
-	canvas[i] = cv::Mat::ones(125, bins, CV_8UC3);
+	const std::vector<long>& hist = stats.getHistogram( i );
+	long hmax = std::max( stats.getMaxBin( i ), 1L );
+
+	cv::Mat canvas = cv::Mat::ones(125, bins, CV_8UC3);
 
-	for (int j = 0, rows = canvas[i].rows; j < bins-1; j++)
+	for (int j = 0, rows = canvas.rows; j < bins; j++)
 	{
 	    cv::line(
-			canvas[i],
+			canvas,
 			cv::Point(j, rows),
-			cv::Point(j, rows - (hist[i].at<int>(j) * rows/hmax[i])),
+			cv::Point(j, rows - (int) (hist[j] * rows / hmax)),
 			nc == 1 ? cv::Scalar(200,200,200) : colors[i],
 			1, 8, 0
 			);
 	}
 
-	cv::imshow(nc == 1 ? "value" : wname[i], canvas[i]);
+	cv::imshow(nc == 1 ? "value" : wname[i], canvas);
     }
 }
 
@@ -134,79 +161,6 @@ double getAngle( cv::RotatedRect boundingRect)
    return atan2( -vector_y , vector_x)*180/3.1415;
 }
 
-void filterContours( std::vector< std::vector<cv::Point> >& srcContours, std::vector< std::vector<cv::Point> >& handContour, const int min, const int max)
-{
-
-
-    std::vector<std::vector<cv::Point> > filteredContours;
-    for (int i = 0; i <srcContours.size(); i++)
-    if ( (int) srcContours[i].size() > min )//&& (int) srcContours[i].size() < max )
-	    filteredContours.push_back( srcContours[i] );
-
-    std::cout << "[Debug] Contours before: " << srcContours.size() << " Contours after: " << filteredContours.size() << std::endl;
-
-
-    //-- Find largest contour:
-    int largestId = 0;
-    if ( (int) filteredContours.size() > 0)
-    {
-
-    int largestValue = (int) filteredContours[0].size();
-    for (int i = 0; i < filteredContours.size(); i++)
-	if ( (int) filteredContours[i].size() > largestValue )
-	{
-	    largestId = i;
-	    largestValue = (int) filteredContours[i].size();
-	}
-    std::cout << "[Debug] Number of contours: " << (int) srcContours.size() << " Largest contour: " << (int) largestValue << std::endl;
-    }
-    else
-	std::cerr << "All filtered!" << std::endl;
-
-
-    handContour.clear();
-    if ( (int) filteredContours.size() > 0)
-	handContour.push_back( filteredContours[largestId]);
-}
-
-
-void backgroundSubs(cv::Mat & frame, backgroundSubstractor & bg)
-{
-    cv::Mat back;
-    cv::Mat fore;
-    bg(frame,fore);
-    bg.getBackgroundImage(back);
-
-
-
-//    Rectangular box: MORPH_RECT
-//    Cross: MORPH_CROSS
-//    Ellipse: MORPH_ELLIPSE
-
-    int erosion_size=0.5;
-    cv::Mat eroding_element = getStructuringElement(cv::MORPH_ELLIPSE,
-                                            cv::Size( 2*erosion_size + 1, 2*erosion_size+1 ),
-                                            cv::Point( erosion_size, erosion_size ) );
-
-    int dilation_size=200;
-    cv::Mat dilating_element = getStructuringElement(cv::MORPH_ELLIPSE,
-                                            cv::Size( 2*erosion_size + 1, 2*erosion_size+1 ),
-                                            cv::Point( erosion_size, erosion_size ) );
-
-    cv::erode(fore,fore,eroding_element);
-    cv::dilate(fore,fore,dilating_element);
-
-//    cv::erode(fore,fore,cv::Mat());
-//    cv::dilate(fore,fore,cv::Mat());
-
-    frame.copyTo(fore,fore);
-
-//    imshow("FORE", fore);
-
-    fore.copyTo(frame);
-}
-
-
 float findAngle(cv::Point start, cv::Point end, cv::Point vertex)
 {
     //-- Note:
@@ -227,6 +181,29 @@ float findAngle(cv::Point start, cv::Point end, cv::Point vertex)
 }
 
 
+float findMaximum(const cv::Mat &src, cv::Point &location)
+{
+    CV_Assert( src.type() == CV_32FC1 );
+
+    float maximum = -FLT_MAX;
+    location = cv::Point( -1, -1 );
+
+    for ( int i = 0; i < src.rows; i++ )
+    {
+        const float * row = src.ptr<float>( i );
+        float row_maximum = rowMaximum( row, src.cols );
+
+        if ( row_maximum > maximum )
+        {
+            maximum = row_maximum;
+            location = cv::Point( std::find( row, row + src.cols, row_maximum ) - row, i );
+        }
+    }
+
+    return maximum;
+}
+
+
 void printProgressBar(cv::Mat &src, cv::Mat &dst, float percentage, cv::Scalar color, int thickness)
 {
     if ( dst.empty() )
@@ -30,7 +30,7 @@
 #include <iostream>
 #include <opencv2/opencv.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
-#include "backgroundSubstractor.h"
+#include "ChannelStats.h"
 
 /*! \fn drawCalibrationMarks
  * \brief Draws a calibration mark centered on the input image, and puts it on the output image
@@ -57,19 +57,6 @@ void drawHistogram(const cv::Mat& image);
  */
 void drawHistogramHSV( const cv::Mat& image);
 
-/*!
- * \brief Filters the contours in a contour vector
- *
- * The criteria for filtering is the contour size, that has to be  larger than the lower threshold (for filtering small blobs) and
- * smaller than the upper threshold ( for filtering large background contours )
- *
- * \param srcContours Vector containing the original contours
- * \param handContour Vector containing the potential hand contours
- * \param min Lower threshold
- * \param max Upper threshold
- */
-void filterContours(std::vector< std::vector<cv::Point> >& srcContours, std::vector< std::vector<cv::Point> >& handContour , const int min = 200, const int max = 1800);
-
 /*!
  * \brief Finds the angle of a rotated rectangle with respect to the X axis
  *
@@ -81,12 +68,6 @@ void filterContours(std::vector< std::vector<cv::Point> >& srcContours, std::vec
  */
 double getAngle( cv::RotatedRect boundingRect);
 
-/*!
- * \brief backgroundSubs
- * \param bg
- */
-void backgroundSubs(cv::Mat &, backgroundSubstractor & bg);
-
 
 //! \brief Stores all the characteristics of a convexity defect in a more convenient way
 struct ConvexityDefect
@@ -127,4 +108,17 @@ float findAngle( cv::Point start, cv::Point end, cv::Point vertex);
  */
 void printProgressBar( cv::Mat& src, cv::Mat& dst, float percentage, cv::Scalar color, int thickness = 15 );
 
+
+/*!
+ * \brief Finds the maximum of a float image, and its first position in raster order
+ *
+ * Each row is reduced with SIMD max operations, and only the rows that raise the maximum are scanned
+ * again to locate it.
+ *
+ * \param src Input image (CV_32FC1), may be a ROI
+ * \param location Output position of the maximum, (-1, -1) if the image is empty
+ * \return The maximum value, -FLT_MAX if the image is empty
+ */
+float findMaximum( const cv::Mat& src, cv::Point& location );
+
 #endif // HANDUTILS_H
@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+//-- jpegDecoder
+//------------------------------------------------------------------------------
+//--
+//-- Decoding of JPEG images at a reduced size, scaling in the DCT domain
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file jpegDecoder.cpp
+ *  \brief Decoding of JPEG images at a reduced size, scaling in the DCT domain
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "jpegDecoder.h"
+#include <cstdio>
+#include <csetjmp>
+#include <fstream>
+#include <vector>
+
+extern "C" {
+#include <jpeglib.h>
+}
+
+namespace
+{
+    //-- Error manager that jumps back to the decoder instead of exiting:
+    struct JPEGErrorManager
+    {
+        jpeg_error_mgr base;
+        jmp_buf jump;
+    };
+
+    void onJPEGError( j_common_ptr cinfo )
+    {
+        longjmp( ( (JPEGErrorManager *) cinfo->err )->jump, 1 );
+    }
+
+    //-- Corrupt MJPEG frames are frequent, the warnings are not printed:
+    void onJPEGMessage( j_common_ptr )
+    {
+    }
+}
+
+int jpegScaleDenominator(const cv::Size &image_size, const cv::Size &processing_size)
+{
+    if ( processing_size.width <= 0 || processing_size.height <= 0 )
+        return 1;
+
+    //-- The decoder rounds the scaled size up:
+    for ( int denominator = 8; denominator > 1; denominator /= 2 )
+        if ( ( image_size.width + denominator - 1 ) / denominator >= processing_size.width
+             && ( image_size.height + denominator - 1 ) / denominator >= processing_size.height )
+            return denominator;
+
+    return 1;
+}
+
+bool isJPEG(const uchar *data, size_t size)
+{
+    return size >= 2 && data[0] == 0xFF && data[1] == 0xD8;
+}
+
+bool decodeJPEG(const uchar *data, size_t size, const cv::Size &processing_size, cv::Mat &dst)
+{
+    if ( !isJPEG( data, size ) )
+        return false;
+
+    jpeg_decompress_struct cinfo;
+    JPEGErrorManager error;
+
+    cinfo.err = jpeg_std_error( &error.base );
+    error.base.error_exit = onJPEGError;
+    error.base.output_message = onJPEGMessage;
+
+    if ( setjmp( error.jump ) )
+    {
+        jpeg_destroy_decompress( &cinfo );
+        return false;
+    }
+
+    jpeg_create_decompress( &cinfo );
+    jpeg_mem_src( &cinfo, (unsigned char *) data, size );
+    jpeg_read_header( &cinfo, TRUE );
+
+    //-- Only greyscale and color images, as cv::imread() handles the rest:
+    if ( cinfo.num_components != 1 && cinfo.num_components != 3 )
+    {
+        jpeg_destroy_decompress( &cinfo );
+        return false;
+    }
+
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = jpegScaleDenominator( cv::Size( cinfo.image_width, cinfo.image_height ), processing_size );
+
+#ifdef JCS_EXTENSIONS
+    cinfo.out_color_space = cinfo.num_components == 1 ? JCS_GRAYSCALE : JCS_EXT_BGR;
+#else
+    cinfo.out_color_space = cinfo.num_components == 1 ? JCS_GRAYSCALE : JCS_RGB;
+#endif
+
+    jpeg_start_decompress( &cinfo );
+
+    //-- Greyscale images are decoded at the end of the output buffer, and expanded in place:
+    dst.create( cinfo.output_height, cinfo.output_width, CV_8UC3 );
+    while ( cinfo.output_scanline < cinfo.output_height )
+    {
+        uchar * row = dst.ptr<uchar>( cinfo.output_scanline );
+        if ( cinfo.output_components == 1 )
+            row += 2 * cinfo.output_width;
+
+        jpeg_read_scanlines( &cinfo, &row, 1 );
+
+        if ( cinfo.output_components == 1 )
+        {
+            uchar * bgr = dst.ptr<uchar>( cinfo.output_scanline - 1 );
+            for ( int j = 0; j < (int) cinfo.output_width; j++ )
+                bgr[3*j] = bgr[3*j+1] = bgr[3*j+2] = row[j];
+        }
+    }
+
+#ifndef JCS_EXTENSIONS
+    if ( cinfo.output_components == 3 )
+        cv::cvtColor( dst, dst, CV_RGB2BGR );
+#endif
+
+    jpeg_finish_decompress( &cinfo );
+    jpeg_destroy_decompress( &cinfo );
+
+    return true;
+}
+
+void readImage(const std::string &file, const cv::Size &processing_size, cv::Mat &dst)
+{
+    std::ifstream stream( file.c_str(), std::ios::binary );
+    std::vector<char> buffer( ( std::istreambuf_iterator<char>( stream ) ), std::istreambuf_iterator<char>() );
+
+    if ( buffer.empty() || !decodeJPEG( (const uchar *) &buffer[0], buffer.size(), processing_size, dst ) )
+        dst = cv::imread( file, CV_LOAD_IMAGE_COLOR );
+}
@@ -0,0 +1,69 @@
+//------------------------------------------------------------------------------
+//-- jpegDecoder
+//------------------------------------------------------------------------------
+//--
+//-- Decoding of JPEG images at a reduced size, scaling in the DCT domain
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file jpegDecoder.h
+ *  \brief Decoding of JPEG images at a reduced size, scaling in the DCT domain
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef JPEGDECODER_H
+#define JPEGDECODER_H
+
+#include <string>
+#include <opencv2/opencv.hpp>
+
+/*!
+ * \brief Returns the largest DCT scaling (1, 2, 4 or 8) that keeps an image at least as large as the processing size
+ *
+ * The JPEG decoder can scale by 1/2, 1/4 or 1/8 while it computes the inverse DCT, which costs less than
+ * decoding the full image, and much less than decoding it and then downsampling it.
+ *
+ * \param image_size Size of the encoded image
+ * \param processing_size Size the image is processed at. If empty, the image is decoded at full size
+ * \return Denominator of the scaling
+ */
+int jpegScaleDenominator( const cv::Size& image_size, const cv::Size& processing_size );
+
+//! \brief Returns true if the buffer starts with a JPEG start of image marker
+bool isJPEG( const uchar * data, size_t size );
+
+/*!
+ * \brief Decodes a JPEG image into BGR, scaled down in the decoder as far as the processing size allows
+ *
+ * \param data Encoded image
+ * \param size Size in bytes of the encoded image
+ * \param processing_size Size the image is processed at (see jpegScaleDenominator())
+ * \param dst BGR output image (CV_8UC3)
+ * \return False if the image could not be decoded
+ */
+bool decodeJPEG( const uchar * data, size_t size, const cv::Size& processing_size, cv::Mat& dst );
+
+/*!
+ * \brief Loads a BGR image from a file, scaling JPEG images down in the decoder
+ *
+ * Images in other formats, or JPEG images the decoder cannot scale, are loaded at full size with cv::imread().
+ *
+ * \param file Path to the image
+ * \param processing_size Size the image is processed at (see jpegScaleDenominator())
+ * \param dst BGR output image (CV_8UC3), empty if the image could not be loaded
+ */
+void readImage( const std::string& file, const cv::Size& processing_size, cv::Mat& dst );
+
+#endif // JPEGDECODER_H
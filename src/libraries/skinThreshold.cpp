@@ -0,0 +1,436 @@
+//------------------------------------------------------------------------------
+//-- skinThreshold
+//------------------------------------------------------------------------------
+//--
+//-- Fast pixel kernels for skin color segmentation
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file skinThreshold.cpp
+ *  \brief Fast pixel kernels for skin color segmentation
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include "skinThreshold.h"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+
+//-- Limits of the HSV range, already converted to the constants used by the comparisons
+//--
+//-- With v = max(b,g,r) and diff = v - min(b,g,r), OpenCV computes:
+//--   s = round( 255 * diff / v )
+//--   h = round( 30 * n / diff ), with n the hue numerator of the sector ( [-diff, 5 diff] )
+//-- so s >= lo  <=>  510 diff >= (2 lo - 1) v  and  s <= hi  <=>  510 diff < (2 hi + 1) v,
+//-- and the same for h with 60 n and diff. No division is needed.
+struct HSVRangeConstants
+{
+    int h_lo, h_hi;     //-- -(2 lo - 1) and -(2 hi + 1) for hue
+    int s_lo, s_hi;     //-- -(2 lo - 1) and -(2 hi + 1) for saturation
+    int v_lo, v_hi;     //-- plain limits for value
+    bool wrap_hue;
+};
+
+static int clampLimit( double value )
+{
+    int v = cvRound( value );
+    return v < 0 ? 0 : ( v > 255 ? 255 : v );
+}
+
+static HSVRangeConstants makeConstants( const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue )
+{
+    HSVRangeConstants c;
+    c.h_lo = -( 2 * clampLimit( lower[0] ) - 1 );
+    c.h_hi = -( 2 * clampLimit( upper[0] ) + 1 );
+    c.s_lo = -( 2 * clampLimit( lower[1] ) - 1 );
+    c.s_hi = -( 2 * clampLimit( upper[1] ) + 1 );
+    c.v_lo = clampLimit( lower[2] );
+    c.v_hi = clampLimit( upper[2] );
+    c.wrap_hue = wrap_hue;
+    return c;
+}
+
+//-- Reference version of the test, used for the image tails and when no SIMD is available
+static inline bool pixelInRange( int b, int g, int r, const HSVRangeConstants& c )
+{
+    int v = std::max( b, std::max( g, r ) );
+    if ( v < c.v_lo || v > c.v_hi )
+        return false;
+
+    int diff = v - std::min( b, std::min( g, r ) );
+
+    //-- Saturation ( s = 0 when v = 0, as in OpenCV )
+    int v1 = v > 0 ? v : 1;
+    if ( 510 * diff + c.s_lo * v1 < 0 || 510 * diff + c.s_hi * v1 >= 0 )
+        return false;
+
+    //-- Hue numerator, same sector selection as cv::cvtColor
+    int n;
+    if ( v == r )       n = g - b;
+    else if ( v == g )  n = b - r + 2 * diff;
+    else                n = r - g + 4 * diff;
+
+    //-- Negative hues round to 0 or wrap to the end of the circle
+    if ( n < 0 )
+        n = ( 60 * n + diff < 0 ) ? n + 6 * diff : 0;
+
+    int d1 = diff > 0 ? diff : 1;
+    bool above_lo = 60 * n + c.h_lo * d1 >= 0;
+    bool below_hi = 60 * n + c.h_hi * d1 < 0;
+
+    return c.wrap_hue ? ( above_lo || below_hi ) : ( above_lo && below_hi );
+}
+
+#if defined(__SSSE3__)
+//-- Packs two 16 bit factors as the 32 bit word that _mm_madd_epi16 pairs with ( lo, hi ) lanes
+static inline int pairOf16( int lo, int hi )
+{
+    return (int) ( ( (unsigned int) hi << 16 ) | (unsigned short) lo );
+}
+
+//-- Splits 16 packed BGR pixels into three planes
+static inline void deinterleaveBGR( const uchar* p, __m128i& b, __m128i& g, __m128i& r )
+{
+    __m128i x0 = _mm_loadu_si128( (const __m128i*) p );
+    __m128i x1 = _mm_loadu_si128( (const __m128i*) ( p + 16 ) );
+    __m128i x2 = _mm_loadu_si128( (const __m128i*) ( p + 32 ) );
+
+    b = _mm_or_si128( _mm_or_si128(
+            _mm_shuffle_epi8( x0, _mm_setr_epi8( 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 ) ),
+            _mm_shuffle_epi8( x1, _mm_setr_epi8( -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1 ) ) ),
+            _mm_shuffle_epi8( x2, _mm_setr_epi8( -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13 ) ) );
+    g = _mm_or_si128( _mm_or_si128(
+            _mm_shuffle_epi8( x0, _mm_setr_epi8( 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 ) ),
+            _mm_shuffle_epi8( x1, _mm_setr_epi8( -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1 ) ) ),
+            _mm_shuffle_epi8( x2, _mm_setr_epi8( -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14 ) ) );
+    r = _mm_or_si128( _mm_or_si128(
+            _mm_shuffle_epi8( x0, _mm_setr_epi8( 2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 ) ),
+            _mm_shuffle_epi8( x1, _mm_setr_epi8( -1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1 ) ) ),
+            _mm_shuffle_epi8( x2, _mm_setr_epi8( -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15 ) ) );
+}
+#endif
+
+#if defined(__AVX2__)
+//-- Tests 16 pixels held as 16 bit lanes, returns 0xFFFF / 0 per lane
+static inline __m256i rangeMask16( __m256i b, __m256i g, __m256i r, const HSVRangeConstants& c )
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16( 1 );
+
+    __m256i v = _mm256_max_epi16( b, _mm256_max_epi16( g, r ) );
+    __m256i diff = _mm256_sub_epi16( v, _mm256_min_epi16( b, _mm256_min_epi16( g, r ) ) );
+
+    //-- Value
+    __m256i mask = _mm256_andnot_si256( _mm256_or_si256( _mm256_cmpgt_epi16( _mm256_set1_epi16( c.v_lo ), v ),
+                                                         _mm256_cmpgt_epi16( v, _mm256_set1_epi16( c.v_hi ) ) ),
+                                        _mm256_set1_epi16( -1 ) );
+
+    //-- Saturation: madd of ( diff, v ) pairs with ( 510, -(2 lim -/+ 1) )
+    __m256i v1 = _mm256_max_epi16( v, one );
+    __m256i dv_lo = _mm256_unpacklo_epi16( diff, v1 );
+    __m256i dv_hi = _mm256_unpackhi_epi16( diff, v1 );
+    __m256i k_slo = _mm256_set1_epi32( pairOf16( 510, c.s_lo ) );
+    __m256i k_shi = _mm256_set1_epi32( pairOf16( 510, c.s_hi ) );
+    __m256i s_ok = _mm256_packs_epi32(
+                _mm256_andnot_si256( _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( dv_lo, k_slo ) ),
+                                     _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( dv_lo, k_shi ) ) ),
+                _mm256_andnot_si256( _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( dv_hi, k_slo ) ),
+                                     _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( dv_hi, k_shi ) ) ) );
+    mask = _mm256_and_si256( mask, s_ok );
+
+    //-- Hue numerator
+    __m256i is_r = _mm256_cmpeq_epi16( v, r );
+    __m256i is_g = _mm256_andnot_si256( is_r, _mm256_cmpeq_epi16( v, g ) );
+    __m256i is_b = _mm256_andnot_si256( _mm256_or_si256( is_r, is_g ), _mm256_set1_epi16( -1 ) );
+    __m256i diff2 = _mm256_add_epi16( diff, diff );
+    __m256i n = _mm256_or_si256( _mm256_or_si256(
+                    _mm256_and_si256( is_r, _mm256_sub_epi16( g, b ) ),
+                    _mm256_and_si256( is_g, _mm256_add_epi16( _mm256_sub_epi16( b, r ), diff2 ) ) ),
+                    _mm256_and_si256( is_b, _mm256_add_epi16( _mm256_sub_epi16( r, g ), _mm256_add_epi16( diff2, diff2 ) ) ) );
+
+    //-- Negative hues: wrap (n += 6 diff) below -0.5, round to 0 otherwise
+    __m256i wrap = _mm256_and_si256( _mm256_cmpgt_epi16( zero, n ),
+                                     _mm256_cmpgt_epi16( zero, _mm256_add_epi16( _mm256_mullo_epi16( n, _mm256_set1_epi16( 60 ) ), diff ) ) );
+    n = _mm256_add_epi16( n, _mm256_and_si256( wrap, _mm256_mullo_epi16( diff, _mm256_set1_epi16( 6 ) ) ) );
+    n = _mm256_max_epi16( n, zero );
+
+    //-- Hue: madd of ( n, diff ) pairs with ( 60, -(2 lim -/+ 1) )
+    __m256i d1 = _mm256_max_epi16( diff, one );
+    __m256i nd_lo = _mm256_unpacklo_epi16( n, d1 );
+    __m256i nd_hi = _mm256_unpackhi_epi16( n, d1 );
+    __m256i k_hlo = _mm256_set1_epi32( pairOf16( 60, c.h_lo ) );
+    __m256i k_hhi = _mm256_set1_epi32( pairOf16( 60, c.h_hi ) );
+    __m256i below_lo = _mm256_packs_epi32( _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( nd_lo, k_hlo ) ),
+                                           _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( nd_hi, k_hlo ) ) );
+    __m256i below_hi = _mm256_packs_epi32( _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( nd_lo, k_hhi ) ),
+                                           _mm256_cmpgt_epi32( zero, _mm256_madd_epi16( nd_hi, k_hhi ) ) );
+    __m256i h_ok = c.wrap_hue ? _mm256_or_si256( _mm256_andnot_si256( below_lo, _mm256_set1_epi16( -1 ) ), below_hi )
+                              : _mm256_andnot_si256( below_lo, below_hi );
+
+    return _mm256_and_si256( mask, h_ok );
+}
+
+#elif defined(__SSSE3__)
+//-- Tests 8 pixels held as 16 bit lanes, returns 0xFFFF / 0 per lane
+static inline __m128i rangeMask8( __m128i b, __m128i g, __m128i r, const HSVRangeConstants& c )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16( 1 );
+
+    __m128i v = _mm_max_epi16( b, _mm_max_epi16( g, r ) );
+    __m128i diff = _mm_sub_epi16( v, _mm_min_epi16( b, _mm_min_epi16( g, r ) ) );
+
+    //-- Value
+    __m128i mask = _mm_andnot_si128( _mm_or_si128( _mm_cmplt_epi16( v, _mm_set1_epi16( c.v_lo ) ),
+                                                   _mm_cmpgt_epi16( v, _mm_set1_epi16( c.v_hi ) ) ),
+                                     _mm_set1_epi16( -1 ) );
+
+    //-- Saturation: madd of ( diff, v ) pairs with ( 510, -(2 lim -/+ 1) )
+    __m128i v1 = _mm_max_epi16( v, one );
+    __m128i dv_lo = _mm_unpacklo_epi16( diff, v1 );
+    __m128i dv_hi = _mm_unpackhi_epi16( diff, v1 );
+    __m128i k_slo = _mm_set1_epi32( pairOf16( 510, c.s_lo ) );
+    __m128i k_shi = _mm_set1_epi32( pairOf16( 510, c.s_hi ) );
+    __m128i s_ok = _mm_packs_epi32(
+                _mm_andnot_si128( _mm_cmplt_epi32( _mm_madd_epi16( dv_lo, k_slo ), zero ),
+                                  _mm_cmplt_epi32( _mm_madd_epi16( dv_lo, k_shi ), zero ) ),
+                _mm_andnot_si128( _mm_cmplt_epi32( _mm_madd_epi16( dv_hi, k_slo ), zero ),
+                                  _mm_cmplt_epi32( _mm_madd_epi16( dv_hi, k_shi ), zero ) ) );
+    mask = _mm_and_si128( mask, s_ok );
+
+    //-- Hue numerator
+    __m128i is_r = _mm_cmpeq_epi16( v, r );
+    __m128i is_g = _mm_andnot_si128( is_r, _mm_cmpeq_epi16( v, g ) );
+    __m128i is_b = _mm_andnot_si128( _mm_or_si128( is_r, is_g ), _mm_set1_epi16( -1 ) );
+    __m128i diff2 = _mm_add_epi16( diff, diff );
+    __m128i n = _mm_or_si128( _mm_or_si128(
+                    _mm_and_si128( is_r, _mm_sub_epi16( g, b ) ),
+                    _mm_and_si128( is_g, _mm_add_epi16( _mm_sub_epi16( b, r ), diff2 ) ) ),
+                    _mm_and_si128( is_b, _mm_add_epi16( _mm_sub_epi16( r, g ), _mm_add_epi16( diff2, diff2 ) ) ) );
+
+    //-- Negative hues: wrap (n += 6 diff) below -0.5, round to 0 otherwise
+    __m128i wrap = _mm_and_si128( _mm_cmplt_epi16( n, zero ),
+                                  _mm_cmplt_epi16( _mm_add_epi16( _mm_mullo_epi16( n, _mm_set1_epi16( 60 ) ), diff ), zero ) );
+    n = _mm_add_epi16( n, _mm_and_si128( wrap, _mm_mullo_epi16( diff, _mm_set1_epi16( 6 ) ) ) );
+    n = _mm_max_epi16( n, zero );
+
+    //-- Hue: madd of ( n, diff ) pairs with ( 60, -(2 lim -/+ 1) )
+    __m128i d1 = _mm_max_epi16( diff, one );
+    __m128i nd_lo = _mm_unpacklo_epi16( n, d1 );
+    __m128i nd_hi = _mm_unpackhi_epi16( n, d1 );
+    __m128i k_hlo = _mm_set1_epi32( pairOf16( 60, c.h_lo ) );
+    __m128i k_hhi = _mm_set1_epi32( pairOf16( 60, c.h_hi ) );
+    __m128i below_lo = _mm_packs_epi32( _mm_cmplt_epi32( _mm_madd_epi16( nd_lo, k_hlo ), zero ),
+                                        _mm_cmplt_epi32( _mm_madd_epi16( nd_hi, k_hlo ), zero ) );
+    __m128i below_hi = _mm_packs_epi32( _mm_cmplt_epi32( _mm_madd_epi16( nd_lo, k_hhi ), zero ),
+                                        _mm_cmplt_epi32( _mm_madd_epi16( nd_hi, k_hhi ), zero ) );
+    __m128i h_ok = c.wrap_hue ? _mm_or_si128( _mm_andnot_si128( below_lo, _mm_set1_epi16( -1 ) ), below_hi )
+                              : _mm_andnot_si128( below_lo, below_hi );
+
+    return _mm_and_si128( mask, h_ok );
+}
+#endif
+
+//-- Thresholds one row of n BGR pixels
+static void thresholdHSVRow( const uchar* src, uchar* dst, int n, const HSVRangeConstants& c )
+{
+    int i = 0;
+
+#if defined(__AVX2__)
+    for ( ; i <= n - 16; i += 16 )
+    {
+        __m128i b, g, r;
+        deinterleaveBGR( src + 3 * i, b, g, r );
+        __m256i m = rangeMask16( _mm256_cvtepu8_epi16( b ), _mm256_cvtepu8_epi16( g ), _mm256_cvtepu8_epi16( r ), c );
+        _mm_storeu_si128( (__m128i*) ( dst + i ),
+                          _mm_packs_epi16( _mm256_castsi256_si128( m ), _mm256_extracti128_si256( m, 1 ) ) );
+    }
+#elif defined(__SSSE3__)
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i <= n - 16; i += 16 )
+    {
+        __m128i b, g, r;
+        deinterleaveBGR( src + 3 * i, b, g, r );
+        __m128i m_lo = rangeMask8( _mm_unpacklo_epi8( b, zero ), _mm_unpacklo_epi8( g, zero ), _mm_unpacklo_epi8( r, zero ), c );
+        __m128i m_hi = rangeMask8( _mm_unpackhi_epi8( b, zero ), _mm_unpackhi_epi8( g, zero ), _mm_unpackhi_epi8( r, zero ), c );
+        _mm_storeu_si128( (__m128i*) ( dst + i ), _mm_packs_epi16( m_lo, m_hi ) );
+    }
+#endif
+
+    for ( ; i < n; i++ )
+        dst[i] = pixelInRange( src[3*i], src[3*i+1], src[3*i+2], c ) ? 255 : 0;
+}
+
+
+void thresholdHSV( const cv::Mat& src, cv::Mat& dst, const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue )
+{
+    CV_Assert( src.type() == CV_8UC3 );
+
+    dst.create( src.size(), CV_8UC1 );
+    HSVRangeConstants c = makeConstants( lower, upper, wrap_hue );
+
+    //-- Treat continuous images as a single long row
+    int rows = src.rows, cols = src.cols;
+    if ( src.isContinuous() && dst.isContinuous() )
+    {
+        cols *= rows;
+        rows = 1;
+    }
+
+    for ( int i = 0; i < rows; i++ )
+        thresholdHSVRow( src.ptr<uchar>(i), dst.ptr<uchar>(i), cols, c );
+}
+
+
+//-- Color space policies for thresholdBox()
+//--
+//-- Each policy has the constants of a box ( Constants, built once by make() ) and an inline test
+//-- of a BGR pixel against them, so that thresholdBoxRows<Policy> compiles to a loop with no call
+//-- nor branch on the color space.
+struct BGRPolicy
+{
+    struct Constants
+    {
+        int lo[3], hi[3];
+    };
+
+    static Constants make( const cv::Scalar& lower, const cv::Scalar& upper, bool )
+    {
+        Constants c;
+        for ( int i = 0; i < 3; i++ )
+        {
+            c.lo[i] = clampLimit( lower[i] );
+            c.hi[i] = clampLimit( upper[i] );
+        }
+        return c;
+    }
+
+    static inline bool test( int b, int g, int r, const Constants& c )
+    {
+        return b >= c.lo[0] && b <= c.hi[0] && g >= c.lo[1] && g <= c.hi[1] && r >= c.lo[2] && r <= c.hi[2];
+    }
+};
+
+struct YCrCbPolicy
+{
+    //-- Fixed point coefficients of cv::cvtColor( CV_BGR2YCrCb ), with a 14 bit shift
+    static const int SHIFT = 14;
+    static const int Y_R = 4899, Y_G = 9617, Y_B = 1868;
+    static const int K_CR = 11682, K_CB = 9241;
+
+    typedef BGRPolicy::Constants Constants;
+
+    static Constants make( const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue )
+    {
+        return BGRPolicy::make( lower, upper, wrap_hue );
+    }
+
+    static inline bool test( int b, int g, int r, const Constants& c )
+    {
+        const int half = 1 << ( SHIFT - 1 );
+        const int delta = 128 << SHIFT;
+
+        int y = ( b * Y_B + g * Y_G + r * Y_R + half ) >> SHIFT;
+        if ( y < c.lo[0] || y > c.hi[0] )
+            return false;
+
+        //-- Cr and Cb never leave [0, 255] for 8 bit inputs, no saturation needed
+        int cr = ( ( r - y ) * K_CR + delta + half ) >> SHIFT;
+        if ( cr < c.lo[1] || cr > c.hi[1] )
+            return false;
+
+        int cb = ( ( b - y ) * K_CB + delta + half ) >> SHIFT;
+        return cb >= c.lo[2] && cb <= c.hi[2];
+    }
+};
+
+struct RGPolicy
+{
+    //-- With s = b + g + r, the chromaticity 255 r / s is in [lo, hi] iff lo s <= 255 r <= hi s
+    typedef BGRPolicy::Constants Constants;
+
+    static Constants make( const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue )
+    {
+        Constants c = BGRPolicy::make( lower, upper, wrap_hue );
+
+        //-- Intensity limits are compared with the sum
+        c.lo[2] *= 3;
+        c.hi[2] *= 3;
+        return c;
+    }
+
+    static inline bool test( int b, int g, int r, const Constants& c )
+    {
+        int sum = b + g + r;
+        if ( sum < c.lo[2] || sum > c.hi[2] )
+            return false;
+
+        //-- Black has r = g = 0
+        int r255 = 255 * r, g255 = 255 * g;
+        return r255 >= c.lo[0] * sum && r255 <= c.hi[0] * sum && g255 >= c.lo[1] * sum && g255 <= c.hi[1] * sum;
+    }
+};
+
+template< class Policy >
+static void thresholdBoxRows( const cv::Mat& src, cv::Mat& dst, const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue )
+{
+    typename Policy::Constants c = Policy::make( lower, upper, wrap_hue );
+
+    //-- Treat continuous images as a single long row
+    int rows = src.rows, cols = src.cols;
+    if ( src.isContinuous() && dst.isContinuous() )
+    {
+        cols *= rows;
+        rows = 1;
+    }
+
+    for ( int i = 0; i < rows; i++ )
+    {
+        const uchar * s = src.ptr<uchar>(i);
+        uchar * d = dst.ptr<uchar>(i);
+
+        for ( int j = 0; j < cols; j++, s += 3 )
+            d[j] = Policy::test( s[0], s[1], s[2], c ) ? 255 : 0;
+    }
+}
+
+//-- HSV has its own SIMD kernel
+static void thresholdHSVRows( const cv::Mat& src, cv::Mat& dst, const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue )
+{
+    thresholdHSV( src, dst, lower, upper, wrap_hue );
+}
+
+typedef void (*ThresholdBoxFunction)( const cv::Mat&, cv::Mat&, const cv::Scalar&, const cv::Scalar&, bool );
+
+//-- Indexed by color space
+static const ThresholdBoxFunction THRESHOLD_BOX_FUNCTIONS[ GECKO_COLOR_SPACES ] = {
+    thresholdHSVRows,
+    thresholdBoxRows< YCrCbPolicy >,
+    thresholdBoxRows< RGPolicy >,
+    thresholdBoxRows< BGRPolicy >
+};
+
+void thresholdBox( const cv::Mat& src, cv::Mat& dst, unsigned int color_space, const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue )
+{
+    CV_Assert( src.type() == CV_8UC3 && color_space < GECKO_COLOR_SPACES );
+
+    dst.create( src.size(), CV_8UC1 );
+    THRESHOLD_BOX_FUNCTIONS[ color_space ]( src, dst, lower, upper, wrap_hue );
+}
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+//-- skinThreshold
+//------------------------------------------------------------------------------
+//--
+//-- Fast pixel kernels for skin color segmentation
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file skinThreshold.h
+ *  \brief Fast pixel kernels for skin color segmentation
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#ifndef SKINTHRESHOLD_H
+#define SKINTHRESHOLD_H
+
+#include <opencv2/opencv.hpp>
+
+//-- Color spaces in which thresholdBox() can test a box
+//! \brief HSV, with the OpenCV 8 bit convention (H in [0, 180) )
+static const unsigned int GECKO_COLOR_SPACE_HSV = 0;
+//! \brief YCrCb, with the OpenCV 8 bit convention (channels in Y, Cr, Cb order)
+static const unsigned int GECKO_COLOR_SPACE_YCRCB = 1;
+//! \brief Normalized rg chromaticity, scaled to [0, 255], plus the intensity (R + G + B) / 3
+static const unsigned int GECKO_COLOR_SPACE_RG = 2;
+//! \brief Raw BGR values
+static const unsigned int GECKO_COLOR_SPACE_BGR = 3;
+//! \brief Number of color spaces supported
+static const unsigned int GECKO_COLOR_SPACES = 4;
+
+/*!
+ * \brief Thresholds a BGR image against a HSV range in a single pass
+ *
+ * Equivalent to cv::cvtColor( CV_BGR2HSV ) followed by cv::inRange(), but the HSV image is never
+ * built: each pixel is converted and tested in registers, with the hue and saturation comparisons
+ * done by cross-multiplication instead of division. Uses SSSE3 / AVX2 when the compiler targets
+ * them and a scalar loop otherwise; all paths give the same result.
+ *
+ * \param src BGR input image (CV_8UC3)
+ * \param dst Binary output image (CV_8UC1), 255 where the pixel is inside the range
+ * \param lower Lower HSV limit (H in [0, 180), OpenCV 8 bit convention)
+ * \param upper Upper HSV limit
+ * \param wrap_hue If true, the hue range wraps around 0: a pixel passes if H >= lower[0] or H <= upper[0]
+ */
+void thresholdHSV( const cv::Mat& src, cv::Mat& dst, const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue = false );
+
+/*!
+ * \brief Thresholds a BGR image against a box in any of the supported color spaces, in a single pass
+ *
+ * Each color space is a policy whose conversion and test are compiled into its own pixel loop, and
+ * the loop is picked at runtime from a table. No converted image is built, and no division is done:
+ * YCrCb only needs the fixed point multiply-adds of cv::cvtColor, and the rg chromaticity is compared
+ * by cross-multiplication. The HSV box uses thresholdHSV().
+ *
+ * \param src BGR input image (CV_8UC3)
+ * \param dst Binary output image (CV_8UC1), 255 where the pixel is inside the box
+ * \param color_space One of the GECKO_COLOR_SPACE_* constants
+ * \param lower Lower limit of the box, in the channel order of the color space
+ * \param upper Upper limit of the box
+ * \param wrap_hue Only for HSV, see thresholdHSV()
+ */
+void thresholdBox( const cv::Mat& src, cv::Mat& dst, unsigned int color_space, const cv::Scalar& lower, const cv::Scalar& upper, bool wrap_hue = false );
+
+#endif // SKINTHRESHOLD_H
@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+//-- masks_test
+//------------------------------------------------------------------------------
+//--
+//-- Checks the bit-packed mask kernels against the equivalent cv::Mat operations
+//--
+//------------------------------------------------------------------------------
+//--
+//-- This file belongs to the "Gecko - Gesture Recognition" project
+//-- (https://github.com/David-Estevez/gecko)
+//--
+//------------------------------------------------------------------------------
+//-- Authors: David Estevez Fernandez
+//--          Irene Sanz Nieto
+//--
+//-- Released under the GPL license (more info on LICENSE.txt file)
+//------------------------------------------------------------------------------
+
+/*! \file masks_test.cpp
+ *  \brief Checks the bit-packed mask kernels against the equivalent cv::Mat operations
+ *
+ * \author David Estevez Fernandez ( http://github.com/David-Estevez )
+ * \author Irene Sanz Nieto ( https://github.com/irenesanznieto )
+ */
+
+#include <iostream>
+#include <deque>
+#include <cstdlib>
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+
+#include "BitMask.h"
+#include "MaskFusion.h"
+
+//-- Widths around the word boundaries, and a few arbitrary ones
+static const int WIDTHS[] = { 1, 5, 63, 64, 65, 100, 127, 128, 129, 191, 200 };
+static const int NUM_WIDTHS = sizeof( WIDTHS ) / sizeof( WIDTHS[0] );
+static const int TRIALS = 20;
+
+static int failures = 0;
+
+//-- Random CV_8UC1 mask (0 / 255), with about density percent of the pixels set
+static cv::Mat randomMask( int rows, int cols, int density )
+{
+    cv::Mat mask( rows, cols, CV_8UC1 );
+    for ( int i = 0; i < rows; i++ )
+        for ( int j = 0; j < cols; j++ )
+            mask.at<uchar>( i, j ) = std::rand() % 100 < density ? 255 : 0;
+
+    return mask;
+}
+
+//-- Compares a bit mask with the expected cv::Mat, pixel by pixel and in its count (which sees the padding bits)
+static void check( const BitMask& result, const cv::Mat& expected, const std::string& test )
+{
+    cv::Mat got;
+    result.toMat( got );
+
+    int differences = 0;
+    if ( got.size() != expected.size() )
+        differences = -1;
+    else
+        for ( int i = 0; i < got.rows; i++ )
+            for ( int j = 0; j < got.cols; j++ )
+                if ( ( got.at<uchar>( i, j ) != 0 ) != ( expected.at<uchar>( i, j ) != 0 ) )
+                    differences++;
+
+    if ( differences == 0 && (int) result.count() != cv::countNonZero( expected ) )
+        differences = -2;
+
+    if ( differences != 0 )
+    {
+        std::cerr << "[Error] " << test << " (" << expected.cols << "x" << expected.rows << "): "
+                  << ( differences == -1 ? "wrong size" : differences == -2 ? "padding bits set" : "pixels differ" )
+                  << std::endl;
+        failures++;
+    }
+}
+
+static void testMorphology( int rows, int cols )
+{
+    cv::Mat mask = randomMask( rows, cols, 70 );
+    BitMask bits, result;
+    bits.fromMat( mask );
+
+    //-- The default borders of OpenCV are the same: outside pixels are set for erode, clear for dilate
+    cv::Mat expected;
+    cv::erode( mask, expected, cv::Mat() );
+    bits.erode( result );
+    check( result, expected, "erode" );
+
+    mask = randomMask( rows, cols, 10 );
+    bits.fromMat( mask );
+    cv::dilate( mask, expected, cv::Mat() );
+    bits.dilate( result );
+    check( result, expected, "dilate" );
+}
+
+static void testCopy( int rows, int cols )
+{
+    cv::Mat mask = randomMask( rows, cols, 50 );
+    BitMask bits;
+    bits.fromMat( mask );
+
+    //-- Region starting at any bit of a word:
+    cv::Rect roi;
+    roi.x = std::rand() % cols;
+    roi.y = std::rand() % rows;
+    roi.width = 1 + std::rand() % ( cols - roi.x );
+    roi.height = 1 + std::rand() % ( rows - roi.y );
+
+    BitMask region;
+    region.copyFrom( bits, roi );
+    check( region, mask( roi ), "copyFrom" );
+
+    //-- Write it back somewhere else in a random mask, keeping the rest of it:
+    cv::Mat target = randomMask( rows, cols, 50 );
+    cv::Point offset( std::rand() % ( cols - roi.width + 1 ), std::rand() % ( rows - roi.height + 1 ) );
+
+    BitMask result;
+    result.fromMat( target );
+    region.copyTo( result, offset );
+
+    mask( roi ).copyTo( target( cv::Rect( offset, roi.size() ) ) );
+    check( result, target, "copyTo" );
+}
+
+static void testFusion( int rows, int cols )
+{
+    int length = 1 + std::rand() % MaskFusion::MAX_LENGTH;
+    int votes = 1 + std::rand() % length;
+    MaskFusion fusion( length, votes );
+
+    //-- Count of each pixel over the last masks, and k of the masks seen while there are fewer than n:
+    std::deque<cv::Mat> last;
+    cv::Mat counts;
+
+    for ( int frame = 0; frame < 2 * length + 3; frame++ )
+    {
+        cv::Mat mask = randomMask( rows, cols, 50 );
+        last.push_back( mask );
+        if ( (int) last.size() > length )
+            last.pop_front();
+
+        counts = cv::Mat::zeros( rows, cols, CV_32SC1 );
+        for ( int m = 0; m < (int) last.size(); m++ )
+            cv::add( counts, last[m] / 255, counts, cv::noArray(), CV_32SC1 );
+
+        int threshold = std::min( votes, (int) last.size() );
+        cv::Mat expected = counts >= threshold;
+
+        BitMask bits;
+        bits.fromMat( mask );
+        fusion.apply( bits );
+        check( bits, expected, "MaskFusion" );
+    }
+}
+
+int main()
+{
+    std::srand( 1 );
+
+    for ( int t = 0; t < TRIALS; t++ )
+        for ( int w = 0; w < NUM_WIDTHS; w++ )
+        {
+            int rows = 1 + std::rand() % 40;
+            testMorphology( rows, WIDTHS[w] );
+            testCopy( rows, WIDTHS[w] );
+            testFusion( rows, WIDTHS[w] );
+        }
+
+    if ( failures )
+        std::cerr << failures << " checks failed" << std::endl;
+    else
+        std::cout << "All mask checks passed" << std::endl;
+
+    return failures ? 1 : 0;
+}